@@ -0,0 +1,18 @@
+#!/bin/sh
+# builds waves-typo, waves-bench and waves-address on Linux, CXX picks another compiler than g++:
+#
+#     BOTAN=/usr/include/botan-2 B58=../base58 ./build.sh
+#
+# BOTAN is the directory holding botan/*.h, B58 the one holding b58.c, LIBS the Botan library.
+# EXTRA=-DWAVES_COUNT_ALLOCS builds the check build that counts hot path heap allocations
+
+CXX=${CXX:-g++}
+BOTAN=${BOTAN:-/usr/include/botan-2}
+B58=${B58:-.}
+LIBS=${LIBS:--lbotan-2}
+FLAGS="-std=c++17 -O2 -Wall -Wextra -I$BOTAN -I$B58 -I. $EXTRA"
+
+for tool in waves-typo waves-bench waves-address; do
+    echo "$CXX $tool.cpp"
+    $CXX $FLAGS $tool.cpp -o $tool -pthread $LIBS || exit 1
+done
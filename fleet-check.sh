@@ -0,0 +1,38 @@
+#!/bin/sh
+# runs one search on localhost as a coordinator with two workers and checks that the fleet finds
+# the seed at the same index as a single process: ./fleet-check.sh [DIR of waves-typo and waves-address]
+
+bin=${1:-.}
+port=${FLEET_CHECK_PORT:-27123}
+seed="apple banana cherry delta echo"
+typo="apple banana cherry delta ecjo"
+args="--threads=1 --strategies=letter-typo"
+
+address=$(echo "$seed" | "$bin/waves-address" -) || exit 1
+single=$("$bin/waves-typo" $args "$address" "$typo" | grep "AT INDEX")
+if [ -z "$single" ]; then
+    echo "fleet-check: a single process did not find the seed"
+    exit 1
+fi
+
+out=$(mktemp -d) || exit 1
+"$bin/waves-typo" $args --coordinator=127.0.0.1:$port --lease=2 "$address" "$typo" > "$out/coordinator" &
+coordinator=$!
+sleep 1
+"$bin/waves-typo" $args --worker=127.0.0.1:$port "$address" "$typo" > "$out/worker1" &
+worker1=$!
+"$bin/waves-typo" $args --worker=127.0.0.1:$port "$address" "$typo" > "$out/worker2" &
+worker2=$!
+
+status=0
+wait $coordinator || status=1
+wait $worker1 || status=1
+wait $worker2 || status=1
+fleet=$(grep "AT INDEX" "$out/coordinator")
+rm -rf "$out"
+
+if [ $status -ne 0 ] || [ "$fleet" != "$single" ]; then
+    echo "fleet-check: FAILED, single process $single, fleet ${fleet:-nothing}"
+    exit 1
+fi
+echo "fleet-check: ok, $single"
@@ -0,0 +1,191 @@
+// bulk seed -> address derivation: every line of FILE or stdin is "seed" or "seed<TAB>nonce",
+// and stdout gets the address of each line, in input order, one per line; the nonce is whatever
+// follows the last tab, so a seed that contains a tab needs the nonce field after it
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "waves-address.h"
+#include "waves-input.h"
+
+static unsigned g_threads;
+static uint32_t g_nonce;
+static uint8_t g_chain = waves_address::mainnet;
+static const waves_simd::kernels * g_simd;
+
+struct derive_line
+{
+    const char * text;
+    size_t len;
+    uint32_t nonce;
+    bool bad;
+};
+
+struct derive_worker
+{
+    derive_worker() : deriver( g_simd ), bad() {}
+
+    waves_address::deriver deriver;
+    std::vector<derive_line> lines;
+    std::vector<waves_address::address> addresses;
+    uint64_t bad;
+};
+
+// splits the line at its last tab into seed and nonce, a line without a tab hashes behind g_nonce;
+// a line whose text after the last tab is not a nonce is bad, never a seed with a tab in it
+derive_line derive_parse( const char * text, size_t len )
+{
+    derive_line line = { text, len, g_nonce, false };
+    size_t tab = len;
+    while( tab > 0 && text[tab - 1] != '\t' )
+        tab--;
+    if( tab == 0 )
+        return line;
+
+    uint64_t nonce = 0;
+    for( size_t i = tab; i < len; i++ )
+    {
+        nonce = nonce * 10 + (uint8_t)( text[i] - '0' );
+        line.bad |= text[i] < '0' || text[i] > '9' || nonce > 0xffffffff;
+    }
+    line.bad |= tab == len;
+    line.len = tab - 1;
+    line.nonce = (uint32_t)nonce;
+    return line;
+}
+
+// the addresses of the lines that start in the block of data at begin, a bad line gets an empty one
+void derive_block( derive_worker & w, const char * data, size_t size, size_t begin, std::string & out )
+{
+    w.lines.clear();
+    waves_input::lines( data, size, begin, begin + waves_input::block_size, [&]( const char * text, size_t len )
+    {
+        w.lines.push_back( derive_parse( text, len ) );
+    } );
+
+    w.addresses.resize( w.lines.size() );
+    for( size_t i = 0; i < w.lines.size(); i++ )
+    {
+        w.addresses[i].text[0] = 0;
+        if( w.lines[i].bad )
+            w.bad++;
+        else
+            w.deriver.add( w.lines[i].text, w.lines[i].len, w.lines[i].nonce, g_chain, &w.addresses[i] );
+    }
+    w.deriver.flush();
+
+    out.clear();
+    out.reserve( w.addresses.size() * ( waves_address::text_size + 1 ) );
+    for( auto & a : w.addresses )
+        out.append( a.text ).push_back( '\n' );
+}
+
+// derives blocks [0, blocks) of data from start on every thread, then writes them in order
+void derive_window( std::vector<derive_worker> & workers, const char * data, size_t size, size_t start, size_t blocks )
+{
+    std::vector<std::string> out( blocks );
+    std::atomic<size_t> next( 0 );
+    std::vector<std::thread> threads;
+    for( size_t t = 0; t < workers.size(); t++ )
+        threads.emplace_back( [&, t]()
+        {
+            for( size_t i; ( i = next++ ) < blocks; )
+                derive_block( workers[t], data, size, start + i * waves_input::block_size, out[i] );
+        } );
+    for( auto & t : threads )
+        t.join();
+
+    for( auto & o : out )
+        fwrite( o.data(), 1, o.size(), stdout );
+}
+
+int main( int argc, char ** argv )
+{
+    g_threads = std::thread::hardware_concurrency();
+    auto cpu = waves_simd::detect();
+    auto isa = cpu;
+    const char * path = nullptr;
+    bool usage = false;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( 0 == strncmp( argv[i], "--threads=", 10 ) )
+            g_threads = strtoul( argv[i] + 10, nullptr, 10 );
+        else if( 0 == strncmp( argv[i], "--nonce=", 8 ) )
+            g_nonce = (uint32_t)strtoul( argv[i] + 8, nullptr, 10 );
+        else if( 0 == strncmp( argv[i], "--chain=", 8 ) && strlen( argv[i] ) == 9 )
+            g_chain = (uint8_t)argv[i][8];
+        else if( 0 == strncmp( argv[i], "--simd=", 7 ) )
+        {
+            std::string name = argv[i] + 7;
+            isa = name == "avx2" ? waves_simd::isa_avx2 : name == "sse4.1" ? waves_simd::isa_sse41 : waves_simd::isa_none;
+        }
+        else if( !path && ( argv[i][0] != '-' || 0 == strcmp( argv[i], "-" ) ) )
+            path = argv[i];
+        else
+            usage = true;
+    }
+    if( usage || !path )
+    {
+        std::cerr << "Usage: waves-address [--threads=N] [--simd=none|sse4.1|avx2] [--nonce=N] [--chain=C] FILE|-" << std::endl;
+        std::cerr << "       a \"seed\" or \"seed<TAB>nonce\" per line in, its address per line out; chain W mainnet, T testnet" << std::endl;
+        std::cerr << "       the nonce follows the last tab, a seed with a tab in it needs one" << std::endl;
+        return 1;
+    }
+    if( g_threads == 0 )
+        g_threads = 1;
+    if( isa > cpu )
+        isa = cpu;
+    g_simd = waves_simd::select( isa );
+
+    std::vector<derive_worker> workers( g_threads );
+    size_t window = g_threads * 16;
+    if( strcmp( path, "-" ) )
+    {
+        waves_input::mapping input;
+        if( !input.open( path ) )
+        {
+            std::cerr << "ERROR: cannot open " << path << std::endl;
+            return 1;
+        }
+
+        size_t blocks = ( input.size() + waves_input::block_size - 1 ) / waves_input::block_size;
+        for( size_t first = 0; first < blocks; first += window )
+            derive_window( workers, input.data(), input.size(), first * waves_input::block_size, std::min( window, blocks - first ) );
+    }
+    else
+    {
+        waves_input::stream in( stdin );
+        for( size_t bytes = window * waves_input::block_size;; )
+        {
+            in.fill( bytes );
+            size_t blocks = in.ready();
+            if( blocks == 0 )
+            {
+                if( in.eof() )
+                    break;
+                bytes *= 2; // a line longer than the window
+                continue;
+            }
+
+            derive_window( workers, in.data(), in.size(), in.start(), blocks );
+            in.drop( blocks );
+        }
+    }
+    fflush( stdout );
+
+    uint64_t bad = 0;
+    for( auto & w : workers )
+        bad += w.bad;
+    if( bad )
+    {
+        std::cerr << "ERROR: " << bad << " lines with a bad nonce, their addresses are empty" << std::endl;
+        return 1;
+    }
+    return 0;
+}
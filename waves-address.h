@@ -0,0 +1,198 @@
+#pragma once
+
+// seeds to Waves addresses outside of a search: a deriver batches seeds over the simd lanes of
+// its own waves_crypto and keeps no other state, so every thread can run one
+//
+//     data     = nonce, 4 bytes big-endian, then the seed text
+//     address  = base58( 1, chain id, pubsechash( data )[0..20), checksum )
+//     checksum = sechash( the 22 bytes before it )[0..4)
+//
+// the chain id is 'W' on mainnet and 'T' on testnet
+//
+// the public keys come from the fixed-base X25519 engine, which is not constant-time: fine for
+// checking candidate seeds, not for deriving the address of a live wallet where the timing can
+// be observed, use curve25519_donna there
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "waves-crypto.h"
+
+namespace waves_address
+{
+
+static const uint8_t version = 1;
+static const uint8_t mainnet = 'W';
+static const uint8_t testnet = 'T';
+static const size_t size = 26;      // decoded bytes
+static const size_t text_size = 36; // base58 digits of size bytes at most
+
+// a view of count objects, as std::span will be
+template <typename T>
+struct span
+{
+    span() : _data(), _size() {}
+    span( T * data, size_t size ) : _data( data ), _size( size ) {}
+    template <typename V>
+    span( V & v ) : _data( v.data() ), _size( v.size() ) {}
+
+    T * data() const { return _data; }
+    size_t size() const { return _size; }
+    T * begin() const { return _data; }
+    T * end() const { return _data + _size; }
+    T & operator[]( size_t i ) const { return _data[i]; }
+
+    T * _data;
+    size_t _size;
+};
+
+struct seed
+{
+    const char * text;
+    size_t len;
+};
+
+struct address
+{
+    char text[text_size + 1]; // zero-terminated
+};
+
+// the prefix the seed text is hashed behind
+inline void put_nonce( uint8_t * data, uint32_t nonce )
+{
+    data[0] = (uint8_t)( nonce >> 24 );
+    data[1] = (uint8_t)( nonce >> 16 );
+    data[2] = (uint8_t)( nonce >> 8 );
+    data[3] = (uint8_t)nonce;
+}
+
+// base58 of up to size bytes with the Bitcoin alphabet, returns the digits written before the zero
+inline size_t base58( const uint8_t * data, size_t len, char * out )
+{
+    static const char alphabet[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+    uint8_t digits[text_size]; // little-endian
+    size_t count = 0;
+
+    size_t zeros = 0;
+    while( zeros < len && data[zeros] == 0 )
+        zeros++;
+
+    for( size_t i = zeros; i < len; i++ )
+    {
+        unsigned carry = data[i];
+        for( size_t j = 0; j < count; j++ )
+        {
+            carry += (unsigned)digits[j] << 8;
+            digits[j] = (uint8_t)( carry % 58 );
+            carry /= 58;
+        }
+        for( ; carry; carry /= 58 )
+            digits[count++] = (uint8_t)( carry % 58 );
+    }
+
+    size_t n = 0;
+    for( ; n < zeros; n++ )
+        out[n] = '1';
+    while( count )
+        out[n++] = alphabet[digits[--count]];
+    out[n] = 0;
+    return n;
+}
+
+// addresses of seeds added one by one, written to their out by the flush() that hashes them
+struct deriver
+{
+    deriver( const waves_simd::kernels * simd = waves_simd::select( waves_simd::detect() ) ) : _crypto( simd ), _len(), _chain(), _out(), _count() {}
+
+    void add( const char * text, size_t len, uint32_t nonce, uint8_t chain_id, address * out )
+    {
+        if( _count && waves_simd::blake2b_blocks( _len[0] ) != waves_simd::blake2b_blocks( 4 + len ) )
+            flush();
+
+        std::vector<uint8_t> & data = _data[_count];
+        if( data.size() < 4 + len )
+            data.resize( ( 4 + len + 127 ) & ~(size_t)127 );
+        put_nonce( data.data(), nonce );
+        memcpy( data.data() + 4, text, len );
+        _len[_count] = 4 + len;
+        _chain[_count] = chain_id;
+        _out[_count] = out;
+
+        if( ++_count == _crypto.lanes() )
+            flush();
+    }
+
+    // hashes the pending seeds, unused lanes repeat the first one
+    void flush()
+    {
+        if( _count == 0 )
+            return;
+
+        const uint8_t * data[waves_simd::max_lanes];
+        for( size_t i = 0; i < _crypto.lanes(); i++ )
+        {
+            size_t j = i < _count ? i : 0;
+            data[i] = _data[j].data();
+            _len[i] = _len[j];
+            _chain[i] = _chain[j];
+        }
+
+        auto hashes = _crypto.pubsechash_xN( data, _len, _count );
+        uint8_t body[waves_simd::max_lanes][size];
+        for( size_t i = 0; i < _crypto.lanes(); i++ )
+        {
+            body[i][0] = version;
+            body[i][1] = _chain[i];
+            memcpy( &body[i][2], hashes[i], 20 );
+        }
+
+        // the checksums are one more batch of sechash over 22 bytes
+        if( _crypto._simd )
+        {
+            static const size_t len22[waves_simd::max_lanes] = { 22, 22, 22, 22, 22, 22, 22, 22 };
+            uint8_t sum[waves_simd::max_lanes][32];
+            const uint8_t * in[waves_simd::max_lanes];
+            uint8_t * out[waves_simd::max_lanes];
+            for( size_t i = 0; i < _crypto.lanes(); i++ )
+            {
+                in[i] = body[i];
+                out[i] = sum[i];
+            }
+            _crypto._simd->blake2b256( in, len22, out );
+            _crypto._simd->keccak256_32( out, out );
+            for( size_t i = 0; i < _count; i++ )
+                memcpy( &body[i][22], sum[i], 4 );
+        }
+        else
+            memcpy( &body[0][22], _crypto.sechash( body[0], 22 ), 4 );
+
+        for( size_t i = 0; i < _count; i++ )
+            base58( body[i], size, _out[i]->text );
+        _count = 0;
+    }
+
+    void derive( span<const seed> seeds, uint32_t nonce, uint8_t chain_id, address * out )
+    {
+        for( size_t i = 0; i < seeds.size(); i++ )
+            add( seeds[i].text, seeds[i].len, nonce, chain_id, &out[i] );
+        flush();
+    }
+
+    waves_crypto _crypto;
+    std::vector<uint8_t> _data[waves_simd::max_lanes];
+    size_t _len[waves_simd::max_lanes];
+    uint8_t _chain[waves_simd::max_lanes];
+    address * _out[waves_simd::max_lanes];
+    size_t _count;
+};
+
+// out[i] = the address of seeds[i] behind nonce on chain_id; safe to call from any thread,
+// each thread keeps one deriver and its lane buffers across calls
+inline void derive_addresses( span<const seed> seeds, uint32_t nonce, uint8_t chain_id, address * out )
+{
+    static thread_local deriver d;
+    d.derive( seeds, nonce, chain_id, out );
+}
+
+} // namespace waves_address
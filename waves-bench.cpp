@@ -0,0 +1,171 @@
+// throughput of every step of the pubsechash chain, scalar and batched, in ns/op and ops/s
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _MSC_VER
+#pragma warning( push )
+#pragma warning( disable : 4250 ) // inherits via dominance
+#endif
+#include <botan/curve25519.h>
+#ifdef _MSC_VER
+#pragma warning( pop )
+#endif
+
+#include "waves-crypto.h"
+
+static const uint8_t g_base9[32] = { 9 };
+static double g_seconds = 0.5;
+static volatile uint8_t g_sink;
+
+// runs f( i ) until g_seconds pass, each call does per_call operations
+template <typename F>
+void bench( const std::string & name, size_t per_call, F f )
+{
+    typedef std::chrono::steady_clock clock;
+    for( size_t i = 0; i < 16; i++ )
+        f( i );
+
+    size_t calls = 0;
+    auto start = clock::now();
+    double elapsed = 0;
+    for( size_t batch = 16; elapsed < g_seconds; batch *= 2 )
+    {
+        for( size_t i = 0; i < batch; i++ )
+            f( calls + i );
+        calls += batch;
+        elapsed = std::chrono::duration<double>( clock::now() - start ).count();
+    }
+
+    double ops = (double)calls * per_call;
+    std::cout << std::left << std::setw( 52 ) << name << std::right
+        << std::setw( 12 ) << std::fixed << std::setprecision( 1 ) << elapsed * 1e9 / ops << " ns/op"
+        << std::setw( 14 ) << std::setprecision( 0 ) << ops / elapsed << " ops/s" << std::endl;
+}
+
+// nonce-prefixed candidates of one length, like the typo strategies produce
+struct candidates
+{
+    candidates( std::mt19937_64 & rng, size_t len, size_t count ) : len( len ), data( count, std::vector<uint8_t>( len ) )
+    {
+        static const char letters[] = "abcdefghijklmnopqrstuvwxyz ";
+        for( auto & c : data )
+            for( size_t i = 4; i < len; i++ )
+                c[i] = letters[rng() % ( sizeof( letters ) - 1 )];
+    }
+
+    uint8_t * operator[]( size_t i )
+    {
+        return data[i % data.size()].data();
+    }
+
+    size_t len;
+    std::vector<std::vector<uint8_t>> data;
+};
+
+void bench_scalar( candidates & seeds )
+{
+    std::string len = " (" + std::to_string( seeds.len ) + " bytes)";
+    botan_hashes botan;
+    uint8_t out[32];
+
+    bench( "botan blake2b256" + len, 1, [&]( size_t i ) { botan.blake2b256( seeds[i], seeds.len, out ); g_sink = out[0]; } );
+    if( seeds.len <= 128 )
+        bench( "fixed blake2b256" + len, 1, [&]( size_t i ) { waves_fixed::blake2b256( seeds[i], seeds.len, out ); g_sink = out[0]; } );
+
+    waves_crypto_t<botan_hashes> slow;
+    waves_crypto fast;
+    bench( "botan pubsechash + curve25519_donna" + len, 1, [&]( size_t i )
+    {
+        uint8_t * sechash = slow.sechash( seeds[i], seeds.len );
+        slow._hashes.sha256( sechash, 32, out );
+        Botan::curve25519_donna( out, out, g_base9 );
+        g_sink = slow.sechash( out, 32 )[0];
+    } );
+    bench( "fixed pubsechash + x25519 fixed-base" + len, 1, [&]( size_t i ) { g_sink = fast.pubsechash( seeds[i], seeds.len )[0]; } );
+}
+
+void bench_batched( candidates & seeds, waves_simd::isa isa )
+{
+    const waves_simd::kernels * k = waves_simd::select( isa );
+    std::string suffix = std::string( " x" ) + std::to_string( k->lanes ) + " " + waves_simd::isa_name( isa ) + " (" + std::to_string( seeds.len ) + " bytes)";
+    uint8_t buf[waves_simd::max_lanes][32];
+    uint8_t * out[waves_simd::max_lanes];
+    size_t len[waves_simd::max_lanes];
+    for( size_t i = 0; i < waves_simd::max_lanes; i++ )
+    {
+        out[i] = buf[i];
+        len[i] = seeds.len;
+    }
+
+    auto lanes = [&]( size_t call, const uint8_t ** in )
+    {
+        for( size_t i = 0; i < k->lanes; i++ )
+            in[i] = seeds[call * k->lanes + i];
+    };
+
+    bench( "blake2b256" + suffix, k->lanes, [&]( size_t call )
+    {
+        const uint8_t * in[waves_simd::max_lanes];
+        lanes( call, in );
+        k->blake2b256( in, len, out );
+        g_sink = buf[0][0];
+    } );
+    bench( "keccak256_32" + suffix, k->lanes, [&]( size_t ) { k->keccak256_32( out, out ); g_sink = buf[0][0]; } );
+    bench( "sha256_32" + suffix, k->lanes, [&]( size_t ) { k->sha256_32( out, out ); g_sink = buf[0][0]; } );
+    bench( "x25519 scalarmult_base_xN" + suffix, k->lanes, [&]( size_t ) { waves_x25519::scalarmult_base_xN( out, out, k->lanes ); g_sink = buf[0][0]; } );
+
+    waves_crypto crypto( k );
+    bench( "pubsechash_xN" + suffix, k->lanes, [&]( size_t call )
+    {
+        const uint8_t * in[waves_simd::max_lanes];
+        lanes( call, in );
+        g_sink = crypto.pubsechash_xN( in, len, k->lanes )[0][0];
+    } );
+}
+
+int main( int argc, char ** argv )
+{
+    std::vector<size_t> lens = { 4 + 60, 4 + 100, 4 + 140 };
+    for( int i = 1; i < argc; i++ )
+    {
+        if( 0 == strncmp( argv[i], "--seconds=", 10 ) )
+            g_seconds = atof( argv[i] + 10 );
+        else if( 0 == strncmp( argv[i], "--len=", 6 ) )
+            lens = { 4 + strtoul( argv[i] + 6, nullptr, 10 ) };
+        else
+        {
+            std::cout << "Usage: waves-bench [--seconds=S] [--len=SEED_LENGTH]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937_64 rng( 1 );
+    auto cpu = waves_simd::detect();
+    std::cout << "waves-bench (" << __DATE__ << "), simd: " << waves_simd::isa_name( cpu ) << std::endl;
+
+    uint8_t in[32] = { 1 }, out[32] = {};
+    botan_hashes botan;
+    bench( "botan keccak256 (32 bytes)", 1, [&]( size_t ) { botan.keccak256( in, 32, out ); in[0] = out[0]; } );
+    bench( "fixed keccak256_32", 1, [&]( size_t ) { waves_fixed::keccak256_32( in, out ); in[0] = out[0]; } );
+    bench( "botan sha256 (32 bytes)", 1, [&]( size_t ) { botan.sha256( in, 32, out ); in[0] = out[0]; } );
+    bench( "fixed sha256_32", 1, [&]( size_t ) { waves_fixed::sha256_32( in, out ); in[0] = out[0]; } );
+    bench( "curve25519_donna", 1, [&]( size_t ) { Botan::curve25519_donna( out, in, g_base9 ); in[0] = out[0]; } );
+    bench( "x25519 scalarmult_base", 1, [&]( size_t ) { waves_x25519::scalarmult_base( out, in ); in[0] = out[0]; } );
+
+    for( size_t len : lens )
+    {
+        candidates seeds( rng, len, 64 );
+        bench_scalar( seeds );
+        for( auto isa : { waves_simd::isa_sse41, waves_simd::isa_avx2 } )
+            if( isa <= cpu )
+                bench_batched( seeds, isa );
+    }
+
+    return 0;
+}
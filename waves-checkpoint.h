@@ -0,0 +1,138 @@
+#pragma once
+
+// completed ranges of global block indexes, saved to a text file so a search can resume
+//
+//     waves-typo checkpoint <signature>
+//     <begin> <end>
+//     ...
+//
+// the signature ties the file to one seed, plan and target set; ranges are [begin, end)
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace waves_checkpoint
+{
+
+struct ranges
+{
+    ranges() : _signature() {}
+
+    // false when the file exists but belongs to another search
+    bool load( const std::string & path, uint64_t signature )
+    {
+        _path = path;
+        _signature = signature;
+
+        std::ifstream file( path );
+        if( !file )
+            file.open( path + ".tmp" );
+        if( !file )
+            return true;
+
+        std::string magic, kind;
+        uint64_t saved = 0;
+        file >> magic >> kind >> std::hex >> saved >> std::dec;
+        if( magic != "waves-typo" || kind != "checkpoint" || saved != signature )
+            return false;
+
+        for( uint64_t begin, end; file >> begin >> end; )
+            if( begin < end )
+                _loaded.push_back( { begin, end } );
+
+        _completed.insert( _loaded.begin(), _loaded.end() );
+        merge();
+        _loaded.assign( _completed.begin(), _completed.end() );
+        return true;
+    }
+
+    // completed before this run, safe to call from any thread
+    bool loaded( uint64_t index ) const
+    {
+        size_t lo = 0, hi = _loaded.size();
+        while( lo < hi )
+        {
+            size_t mid = ( lo + hi ) / 2;
+            if( _loaded[mid].second <= index )
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo < _loaded.size() && _loaded[lo].first <= index;
+    }
+
+    void complete( uint64_t begin, uint64_t end )
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        uint64_t & e = _completed[begin];
+        if( e < end )
+            e = end;
+        merge();
+    }
+
+    uint64_t size() const
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        uint64_t n = 0;
+        for( auto & r : _completed )
+            n += r.second - r.first;
+        return n;
+    }
+
+    // writes path.tmp first so a crash while saving leaves one readable copy
+    bool save()
+    {
+        if( _path.empty() )
+            return true;
+
+        std::ostringstream text;
+        {
+            std::lock_guard<std::mutex> lock( _mutex );
+            text << "waves-typo checkpoint " << std::hex << _signature << std::dec << "\n";
+            for( auto & r : _completed )
+                text << r.first << " " << r.second << "\n";
+        }
+
+        std::string tmp = _path + ".tmp";
+        {
+            std::ofstream file( tmp, std::ios::trunc );
+            if( !( file << text.str() ) || !file.flush() )
+                return false;
+        }
+
+        std::remove( _path.c_str() );
+        return 0 == std::rename( tmp.c_str(), _path.c_str() );
+    }
+
+    // joins adjacent and overlapping ranges, the caller holds the lock
+    void merge()
+    {
+        for( auto i = _completed.begin(); i != _completed.end(); )
+        {
+            auto next = std::next( i );
+            if( next != _completed.end() && next->first <= i->second )
+            {
+                if( next->second > i->second )
+                    i->second = next->second;
+                _completed.erase( next );
+            }
+            else
+                i = next;
+        }
+    }
+
+    std::string _path;
+    uint64_t _signature;
+    std::vector<std::pair<uint64_t, uint64_t>> _loaded;
+    std::map<uint64_t, uint64_t> _completed;
+    mutable std::mutex _mutex;
+};
+
+} // namespace waves_checkpoint
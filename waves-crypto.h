@@ -0,0 +1,132 @@
+#pragma once
+
+// the Waves seed -> address hash chain: sechash = Keccak-256( Blake2b-256( data ) ),
+// pub = X25519( SHA-256( sechash ), 9 ), pubsechash = sechash( pub ), over a choice of
+// hash backends and optionally batched over the lanes of waves-simd.h
+
+#include <cstdint>
+#include <cstring>
+
+#include <botan/blake2b.h>
+#include <botan/keccak.h>
+#include <botan/sha2_32.h>
+
+#include "waves-simd.h"
+#include "waves-fixed.h"
+#include "waves-x25519.h"
+
+// generic Botan objects, any input length
+struct botan_hashes
+{
+    botan_hashes() : _blake2b( 256 ), _keccak256( 256 ) {};
+
+    void blake2b256( const uint8_t * data, size_t len, uint8_t * out )
+    {
+        _blake2b.update( data, len );
+        _blake2b.final( out );
+    }
+
+    void keccak256( const uint8_t * data, size_t len, uint8_t * out )
+    {
+        _keccak256.update( data, len );
+        _keccak256.final( out );
+    }
+
+    void sha256( const uint8_t * data, size_t len, uint8_t * out )
+    {
+        _sha256.update( data, len );
+        _sha256.final( out );
+    }
+
+    Botan::Blake2b _blake2b;
+    Botan::Keccak_1600 _keccak256;
+    Botan::SHA_256 _sha256;
+};
+
+// single-block kernels for the lengths they cover, Botan for the rest
+struct fixed_hashes : botan_hashes
+{
+    void blake2b256( const uint8_t * data, size_t len, uint8_t * out )
+    {
+        if( len <= 128 )
+            waves_fixed::blake2b256( data, len, out );
+        else
+            botan_hashes::blake2b256( data, len, out );
+    }
+
+    void keccak256( const uint8_t * data, size_t len, uint8_t * out )
+    {
+        if( len == 32 )
+            waves_fixed::keccak256_32( data, out );
+        else
+            botan_hashes::keccak256( data, len, out );
+    }
+
+    void sha256( const uint8_t * data, size_t len, uint8_t * out )
+    {
+        if( len == 32 )
+            waves_fixed::sha256_32( data, out );
+        else
+            botan_hashes::sha256( data, len, out );
+    }
+};
+
+template <typename hashes>
+struct waves_crypto_t
+{
+    // without simd kernels pubsechash_xN() hashes one candidate per call
+    waves_crypto_t( const waves_simd::kernels * simd = nullptr ) : _buf(), _simd( simd ), _bufN() {};
+
+    auto sechash( uint8_t * data, size_t len )
+    {
+        _hashes.blake2b256( data, len, _buf );
+        _hashes.keccak256( _buf, 32, _buf );
+        return _buf;
+    }
+
+    auto pub( uint8_t * data, size_t len )
+    {
+        _hashes.sha256( sechash( data, len ), 32, _buf );
+        waves_x25519::scalarmult_base( _buf, _buf );
+        return _buf;
+    }
+
+    auto pubsechash( uint8_t * data, size_t len )
+    {
+        return sechash( pub( data, len ), 32 );
+    }
+
+    size_t lanes() const
+    {
+        return _simd ? _simd->lanes : 1;
+    }
+
+    // pubsechash of lanes() candidates at once, only the first count results are meaningful
+    auto pubsechash_xN( const uint8_t * const * data, const size_t * len, size_t count )
+    {
+        if( !_simd )
+        {
+            memcpy( _bufN[0], pubsechash( (uint8_t *)data[0], len[0] ), 32 );
+            return _bufN;
+        }
+
+        uint8_t * out[waves_simd::max_lanes];
+        for( size_t i = 0; i < _simd->lanes; i++ )
+            out[i] = _bufN[i];
+
+        _simd->blake2b256( data, len, out );
+        _simd->keccak256_32( out, out );
+        _simd->sha256_32( out, out );
+        waves_x25519::scalarmult_base_xN( out, out, count );
+        _simd->blake2b256( out, waves_simd::len32, out );
+        _simd->keccak256_32( out, out );
+        return _bufN;
+    }
+
+    hashes _hashes;
+    uint8_t _buf[32];
+    const waves_simd::kernels * _simd;
+    uint8_t _bufN[waves_simd::max_lanes][32];
+};
+
+typedef waves_crypto_t<fixed_hashes> waves_crypto;
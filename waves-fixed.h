@@ -0,0 +1,195 @@
+#pragma once
+
+// single-block hash kernels for the fixed input lengths of the pubsechash chain,
+// bypassing the buffered update()/final() of the generic Botan objects
+
+#include "waves-simd.h"
+
+#include <utility>
+
+namespace waves_fixed
+{
+
+using waves_simd::blake2b_iv;
+using waves_simd::blake2b_sigma;
+using waves_simd::keccak_rc;
+using waves_simd::sha256_h0;
+using waves_simd::sha256_k;
+using waves_simd::load_be32;
+using waves_simd::store_be32;
+
+inline uint64_t rotr64( uint64_t x, int n ) { return ( x >> n ) | ( x << ( 64 - n ) ); }
+inline uint64_t rotl64( uint64_t x, int n ) { return ( x << n ) | ( x >> ( 64 - n ) ); }
+inline uint32_t rotr32( uint32_t x, int n ) { return ( x >> n ) | ( x << ( 32 - n ) ); }
+
+// Blake2b-256 of exactly len <= 128 bytes: one compression with the final flag set
+
+inline void blake2b_g( uint64_t * v, int a, int b, int c, int d, uint64_t x, uint64_t y )
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotr64( v[d] ^ v[a], 32 );
+    v[c] = v[c] + v[d];
+    v[b] = rotr64( v[b] ^ v[c], 24 );
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotr64( v[d] ^ v[a], 16 );
+    v[c] = v[c] + v[d];
+    v[b] = rotr64( v[b] ^ v[c], 63 );
+}
+
+template <size_t len>
+inline void blake2b256( const uint8_t * in, uint8_t * out )
+{
+    static_assert( len <= 128, "one Blake2b block" );
+
+    uint64_t m[16] = {};
+    memcpy( m, in, len );
+
+    uint64_t v[16];
+    for( int i = 0; i < 8; i++ )
+    {
+        v[i] = blake2b_iv[i];
+        v[i + 8] = blake2b_iv[i];
+    }
+    v[0] ^= 0x01010000 ^ 32;
+    v[12] ^= len;
+    v[14] = ~v[14];
+
+    for( int r = 0; r < 12; r++ )
+    {
+        const uint8_t * s = blake2b_sigma[r % 10];
+        blake2b_g( v, 0, 4, 8, 12, m[s[0]], m[s[1]] );
+        blake2b_g( v, 1, 5, 9, 13, m[s[2]], m[s[3]] );
+        blake2b_g( v, 2, 6, 10, 14, m[s[4]], m[s[5]] );
+        blake2b_g( v, 3, 7, 11, 15, m[s[6]], m[s[7]] );
+        blake2b_g( v, 0, 5, 10, 15, m[s[8]], m[s[9]] );
+        blake2b_g( v, 1, 6, 11, 12, m[s[10]], m[s[11]] );
+        blake2b_g( v, 2, 7, 8, 13, m[s[12]], m[s[13]] );
+        blake2b_g( v, 3, 4, 9, 14, m[s[14]], m[s[15]] );
+    }
+
+    uint64_t h[4];
+    for( int i = 0; i < 4; i++ )
+        h[i] = blake2b_iv[i] ^ v[i] ^ v[i + 8];
+    h[0] ^= 0x01010000 ^ 32;
+    memcpy( out, h, 32 );
+}
+
+typedef void ( *blake2b256_fn )( const uint8_t * in, uint8_t * out );
+
+template <size_t... lens>
+inline const blake2b256_fn * blake2b256_table( std::index_sequence<lens...> )
+{
+    static const blake2b256_fn t[] = { blake2b256<lens>... };
+    return t;
+}
+
+// one instantiation per length, seeds are dispatched through a table
+inline void blake2b256( const uint8_t * in, size_t len, uint8_t * out )
+{
+    static const blake2b256_fn * t = blake2b256_table( std::make_index_sequence<129>() );
+    t[len]( in, out );
+}
+
+// Keccak-256 (original padding) of exactly 32 bytes: one absorb into the 136-byte rate
+
+inline void keccak_f1600( uint64_t * a )
+{
+    for( int r = 0; r < 24; r++ )
+    {
+        uint64_t c[5], d[5], b[25];
+        for( int x = 0; x < 5; x++ )
+            c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        for( int x = 0; x < 5; x++ )
+            d[x] = c[( x + 4 ) % 5] ^ rotl64( c[( x + 1 ) % 5], 1 );
+
+        // theta, rho and pi: lane x + 5 * y moves to y + 5 * ( ( 2 * x + 3 * y ) % 5 )
+        b[0] = a[0] ^ d[0];
+        b[10] = rotl64( a[1] ^ d[1], 1 );
+        b[20] = rotl64( a[2] ^ d[2], 62 );
+        b[5] = rotl64( a[3] ^ d[3], 28 );
+        b[15] = rotl64( a[4] ^ d[4], 27 );
+        b[16] = rotl64( a[5] ^ d[0], 36 );
+        b[1] = rotl64( a[6] ^ d[1], 44 );
+        b[11] = rotl64( a[7] ^ d[2], 6 );
+        b[21] = rotl64( a[8] ^ d[3], 55 );
+        b[6] = rotl64( a[9] ^ d[4], 20 );
+        b[7] = rotl64( a[10] ^ d[0], 3 );
+        b[17] = rotl64( a[11] ^ d[1], 10 );
+        b[2] = rotl64( a[12] ^ d[2], 43 );
+        b[12] = rotl64( a[13] ^ d[3], 25 );
+        b[22] = rotl64( a[14] ^ d[4], 39 );
+        b[23] = rotl64( a[15] ^ d[0], 41 );
+        b[8] = rotl64( a[16] ^ d[1], 45 );
+        b[18] = rotl64( a[17] ^ d[2], 15 );
+        b[3] = rotl64( a[18] ^ d[3], 21 );
+        b[13] = rotl64( a[19] ^ d[4], 8 );
+        b[14] = rotl64( a[20] ^ d[0], 18 );
+        b[24] = rotl64( a[21] ^ d[1], 2 );
+        b[9] = rotl64( a[22] ^ d[2], 61 );
+        b[19] = rotl64( a[23] ^ d[3], 56 );
+        b[4] = rotl64( a[24] ^ d[4], 14 );
+
+        for( int y = 0; y < 25; y += 5 )
+        for( int x = 0; x < 5; x++ )
+            a[y + x] = b[y + x] ^ ( ~b[y + ( x + 1 ) % 5] & b[y + ( x + 2 ) % 5] );
+
+        a[0] ^= keccak_rc[r];
+    }
+}
+
+inline void keccak256_32( const uint8_t * in, uint8_t * out )
+{
+    uint64_t a[25] = {};
+    memcpy( a, in, 32 );
+    a[4] = 0x01;
+    a[16] = 0x8000000000000000ULL;
+
+    keccak_f1600( a );
+    memcpy( out, a, 32 );
+}
+
+// SHA-256 of exactly 32 bytes: one block, words 8..15 are the constant padding
+
+inline void sha256_32( const uint8_t * in, uint8_t * out )
+{
+    uint32_t w[64];
+    for( int i = 0; i < 8; i++ )
+        w[i] = load_be32( in + i * 4 );
+    w[8] = 0x80000000;
+    w[9] = w[10] = w[11] = w[12] = w[13] = w[14] = 0;
+    w[15] = 256;
+
+    for( int i = 16; i < 64; i++ )
+    {
+        uint32_t s0 = rotr32( w[i - 15], 7 ) ^ rotr32( w[i - 15], 18 ) ^ ( w[i - 15] >> 3 );
+        uint32_t s1 = rotr32( w[i - 2], 17 ) ^ rotr32( w[i - 2], 19 ) ^ ( w[i - 2] >> 10 );
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha256_h0[0], b = sha256_h0[1], c = sha256_h0[2], d = sha256_h0[3];
+    uint32_t e = sha256_h0[4], f = sha256_h0[5], g = sha256_h0[6], h = sha256_h0[7];
+    for( int i = 0; i < 64; i++ )
+    {
+        uint32_t t1 = h + ( rotr32( e, 6 ) ^ rotr32( e, 11 ) ^ rotr32( e, 25 ) ) + ( ( e & f ) ^ ( ~e & g ) ) + sha256_k[i] + w[i];
+        uint32_t t2 = ( rotr32( a, 2 ) ^ rotr32( a, 13 ) ^ rotr32( a, 22 ) ) + ( ( a & b ) | ( c & ( a | b ) ) );
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    store_be32( out, sha256_h0[0] + a );
+    store_be32( out + 4, sha256_h0[1] + b );
+    store_be32( out + 8, sha256_h0[2] + c );
+    store_be32( out + 12, sha256_h0[3] + d );
+    store_be32( out + 16, sha256_h0[4] + e );
+    store_be32( out + 20, sha256_h0[5] + f );
+    store_be32( out + 24, sha256_h0[6] + g );
+    store_be32( out + 28, sha256_h0[7] + h );
+}
+
+} // namespace waves_fixed
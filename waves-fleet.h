@@ -0,0 +1,545 @@
+#pragma once
+
+// one search spread over many waves-typo processes: a coordinator hands out leases on
+// ranges of global block indexes over TCP, workers hash them and report back
+//
+// the protocol is one text line per message:
+//
+//     worker -> coordinator   HELLO <signature>
+//                             HEARTBEAT <probes>           cumulative, about once a second
+//                             DONE <begin> <end>           the lease is hashed completely
+//                             FOUND <target> <index> <seed>
+//     coordinator -> worker   LEASE <begin> <end>
+//                             STOP                         every target is found or every block is done
+//
+// a lease whose worker disconnects or stays silent for longer than the lease timeout goes
+// back to the pending ranges and is handed to the next worker that asks for work
+//
+// the coordinator closes the connection of a worker it gave up on, so a late DONE or FOUND
+// for a reissued lease never arrives: the lease is hashed again in full by its new worker,
+// which finds the same seeds. the worker sees the connection drop, stops hashing the stale
+// lease and exits with an error. a DONE for anything but the current lease of its worker
+// is ignored, and a FOUND for a target already found is counted once
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment( lib, "ws2_32.lib" )
+#else
+#include <csignal>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace waves_fleet
+{
+
+#ifdef _WIN32
+
+typedef SOCKET socket_t;
+static const socket_t bad_socket = INVALID_SOCKET;
+
+inline bool startup()
+{
+    WSADATA wsa;
+    return 0 == WSAStartup( MAKEWORD( 2, 2 ), &wsa );
+}
+
+inline void close_socket( socket_t s )
+{
+    closesocket( s );
+}
+
+inline int poll_sockets( pollfd * fds, size_t count, int ms )
+{
+    return WSAPoll( fds, (ULONG)count, ms );
+}
+
+#else
+
+typedef int socket_t;
+static const socket_t bad_socket = -1;
+
+inline bool startup()
+{
+    signal( SIGPIPE, SIG_IGN );
+    return true;
+}
+
+inline void close_socket( socket_t s )
+{
+    close( s );
+}
+
+inline int poll_sockets( pollfd * fds, size_t count, int ms )
+{
+    return poll( fds, (nfds_t)count, ms );
+}
+
+#endif
+
+inline int64_t now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+// "host:port" or just "port" for localhost; a listening socket when listen is set
+inline socket_t open_socket( const std::string & address, bool listen )
+{
+    std::string host = "127.0.0.1";
+    std::string port = address;
+    size_t colon = address.rfind( ':' );
+    if( colon != std::string::npos )
+    {
+        host = address.substr( 0, colon );
+        port = address.substr( colon + 1 );
+    }
+
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo * list;
+    if( getaddrinfo( host.c_str(), port.c_str(), &hints, &list ) )
+        return bad_socket;
+
+    socket_t s = bad_socket;
+    for( addrinfo * a = list; a; a = a->ai_next )
+    {
+        s = socket( a->ai_family, a->ai_socktype, a->ai_protocol );
+        if( s == bad_socket )
+            continue;
+
+        int one = 1;
+        setsockopt( s, IPPROTO_TCP, TCP_NODELAY, (const char *)&one, sizeof( one ) );
+        if( listen )
+        {
+            setsockopt( s, SOL_SOCKET, SO_REUSEADDR, (const char *)&one, sizeof( one ) );
+            if( 0 == bind( s, a->ai_addr, (int)a->ai_addrlen ) && 0 == ::listen( s, 64 ) )
+                break;
+        }
+        else if( 0 == connect( s, a->ai_addr, (int)a->ai_addrlen ) )
+            break;
+
+        close_socket( s );
+        s = bad_socket;
+    }
+
+    freeaddrinfo( list );
+    return s;
+}
+
+// a socket with line framing, send_line() may be called from any thread
+struct connection
+{
+    connection( socket_t s ) : _socket( s ) {}
+
+    ~connection()
+    {
+        if( _socket != bad_socket )
+            close_socket( _socket );
+    }
+
+    bool send_line( const std::string & line )
+    {
+        std::lock_guard<std::mutex> lock( _send_mutex );
+        std::string data = line + "\n";
+        for( size_t sent = 0; sent < data.size(); )
+        {
+            int n = send( _socket, data.data() + sent, (int)( data.size() - sent ), 0 );
+            if( n <= 0 )
+                return false;
+            sent += n;
+        }
+        return true;
+    }
+
+    // appends whatever has arrived, false once the peer is gone
+    bool receive()
+    {
+        char buf[4096];
+        int n = recv( _socket, buf, sizeof( buf ), 0 );
+        if( n <= 0 )
+            return false;
+        _in.append( buf, n );
+        return true;
+    }
+
+    bool next_line( std::string & line )
+    {
+        size_t end = _in.find( '\n' );
+        if( end == std::string::npos )
+            return false;
+
+        line = _in.substr( 0, end );
+        _in.erase( 0, end + 1 );
+        if( !line.empty() && line.back() == '\r' )
+            line.pop_back();
+        return true;
+    }
+
+    void shutdown_both()
+    {
+#ifdef _WIN32
+        shutdown( _socket, SD_BOTH );
+#else
+        shutdown( _socket, SHUT_RDWR );
+#endif
+    }
+
+    socket_t _socket;
+    std::string _in;
+    std::mutex _send_mutex;
+};
+
+typedef std::pair<uint64_t, uint64_t> range;
+
+struct coordinator
+{
+    coordinator( const std::string & signature, size_t targets, uint64_t lease, int64_t timeout_ms ) :
+        _signature( signature ), _targets( targets ), _found( targets ), _found_count(), _lease( lease ),
+        _timeout_ms( timeout_ms ), _probes(), _left() {}
+
+    // blocks still to hash, in order
+    void add( uint64_t begin, uint64_t end )
+    {
+        if( begin < end )
+        {
+            _pending.push_back( { begin, end } );
+            _left += end - begin;
+        }
+    }
+
+    // serves workers until every block is done or every target is found;
+    // completed( range ) and found( target, index, seed ) report their messages
+    bool run( socket_t listener,
+        std::function<void( const range & )> completed,
+        std::function<void( size_t, uint64_t, const std::string & )> found )
+    {
+        int64_t report = now_ms();
+        uint64_t report_probes = 0;
+        uint64_t total = _left;
+
+        while( _left && _found_count < _targets )
+        {
+            std::vector<pollfd> fds( 1 + _workers.size() );
+            fds[0].fd = listener;
+            fds[0].events = POLLIN;
+            size_t i = 1;
+            for( auto & w : _workers )
+            {
+                fds[i].fd = w.conn->_socket;
+                fds[i++].events = POLLIN;
+            }
+            poll_sockets( fds.data(), fds.size(), 500 );
+
+            if( fds[0].revents & POLLIN )
+            {
+                socket_t s = accept( listener, nullptr, nullptr );
+                if( s != bad_socket )
+                {
+                    _workers.emplace_back();
+                    _workers.back().conn.reset( new connection( s ) );
+                    _workers.back().seen = now_ms();
+                }
+            }
+
+            i = 1;
+            for( auto w = _workers.begin(); w != _workers.end(); i++ )
+            {
+                bool alive = true;
+                if( i < fds.size() && fds[i].revents )
+                {
+                    alive = w->conn->receive();
+                    for( std::string line; alive && w->conn->next_line( line ); )
+                        alive = handle( *w, line, completed, found );
+                }
+
+                if( alive && now_ms() - w->seen > _timeout_ms )
+                {
+                    std::cout << "fleet: worker timed out" << std::endl;
+                    alive = false;
+                }
+
+                if( !alive )
+                {
+                    if( w->leased )
+                        _pending.push_front( w->lease );
+                    w = _workers.erase( w );
+                }
+                else
+                    ++w;
+            }
+
+            for( auto & w : _workers )
+                if( w.hello && !w.leased )
+                    assign( w );
+
+            int64_t now = now_ms();
+            if( now - report >= 10000 )
+            {
+                std::cout << "fleet: " << _workers.size() << " workers, "
+                    << ( _probes - report_probes ) * 1000 / ( now - report ) << " probes/s, "
+                    << total - _left << "/" << total << " blocks" << std::endl;
+                report = now;
+                report_probes = _probes;
+            }
+        }
+
+        for( auto & w : _workers )
+            w.conn->send_line( "STOP" );
+        return _found_count > 0;
+    }
+
+    struct worker
+    {
+        worker() : hello(), leased(), lease(), seen(), probes() {}
+
+        std::unique_ptr<connection> conn;
+        bool hello;
+        bool leased;
+        range lease;
+        int64_t seen;
+        uint64_t probes;
+    };
+
+    bool handle( worker & w, const std::string & line,
+        std::function<void( const range & )> & completed,
+        std::function<void( size_t, uint64_t, const std::string & )> & found )
+    {
+        std::istringstream in( line );
+        std::string kind;
+        in >> kind;
+        w.seen = now_ms();
+
+        if( kind == "HELLO" )
+        {
+            std::string signature;
+            in >> signature;
+            if( signature != _signature )
+            {
+                std::cout << "fleet: worker with another search refused" << std::endl;
+                w.conn->send_line( "STOP" );
+                return false;
+            }
+            w.hello = true;
+        }
+        else if( kind == "HEARTBEAT" )
+        {
+            uint64_t probes = 0;
+            in >> probes;
+            if( probes > w.probes )
+            {
+                _probes += probes - w.probes;
+                w.probes = probes;
+            }
+        }
+        else if( kind == "DONE" )
+        {
+            range r;
+            in >> r.first >> r.second;
+            if( w.leased && r == w.lease )
+            {
+                w.leased = false;
+                _left -= r.second - r.first;
+                completed( r );
+            }
+        }
+        else if( kind == "FOUND" )
+        {
+            size_t target = 0;
+            uint64_t index = 0;
+            std::string seed;
+            in >> target >> index;
+            std::getline( in >> std::ws, seed );
+            if( target < _targets )
+            {
+                found( target, index, seed );
+                if( !_found[target] )
+                {
+                    _found[target] = true;
+                    _found_count++;
+                }
+            }
+        }
+        return true;
+    }
+
+    void assign( worker & w )
+    {
+        if( _pending.empty() )
+            return;
+
+        range & r = _pending.front();
+        w.lease = { r.first, r.second - r.first > _lease ? r.first + _lease : r.second };
+        r.first = w.lease.second;
+        if( r.first == r.second )
+            _pending.pop_front();
+
+        w.leased = w.conn->send_line( "LEASE " + std::to_string( w.lease.first ) + " " + std::to_string( w.lease.second ) );
+        if( !w.leased )
+            _pending.push_front( w.lease );
+    }
+
+    std::string _signature;
+    size_t _targets;
+    std::vector<bool> _found;
+    size_t _found_count;
+    uint64_t _lease;
+    int64_t _timeout_ms;
+    uint64_t _probes;
+    uint64_t _left;
+    std::deque<range> _pending;
+    std::list<worker> _workers;
+};
+
+struct client
+{
+    client() : _stop(), _lost(), _leased() {}
+
+    ~client()
+    {
+        close();
+    }
+
+    // probes() is sampled for the heartbeats, stopped() runs once the coordinator says STOP
+    bool start( const std::string & address, const std::string & signature,
+        std::function<uint64_t()> probes, std::function<void()> stopped )
+    {
+        socket_t s = open_socket( address, false );
+        if( s == bad_socket )
+            return false;
+
+        _conn.reset( new connection( s ) );
+        _probes = probes;
+        _stopped = stopped;
+        if( !_conn->send_line( "HELLO " + signature ) )
+            return false;
+
+        _reader = std::thread( [this]() { read(); } );
+        _heartbeat = std::thread( [this]() { beat(); } );
+        return true;
+    }
+
+    // waits for the next lease, false once the search is over
+    bool next_lease( range & lease )
+    {
+        std::unique_lock<std::mutex> lock( _mutex );
+        _cv.wait( lock, [this]() { return _stop || _leased; } );
+        if( _stop )
+            return false;
+
+        lease = _lease;
+        _leased = false;
+        return true;
+    }
+
+    void done( const range & lease )
+    {
+        _conn->send_line( "DONE " + std::to_string( lease.first ) + " " + std::to_string( lease.second ) );
+    }
+
+    void found( size_t target, uint64_t index, const char * seed )
+    {
+        _conn->send_line( "FOUND " + std::to_string( target ) + " " + std::to_string( index ) + " " + seed );
+    }
+
+    void close()
+    {
+        if( !_conn )
+            return;
+
+        stop();
+        _conn->shutdown_both();
+        if( _reader.joinable() )
+            _reader.join();
+        if( _heartbeat.joinable() )
+            _heartbeat.join();
+        _conn.reset();
+    }
+
+    void read()
+    {
+        std::string line;
+        while( _conn->receive() )
+            while( _conn->next_line( line ) )
+            {
+                if( line.compare( 0, 6, "LEASE " ) == 0 )
+                {
+                    std::istringstream in( line.substr( 6 ) );
+                    std::lock_guard<std::mutex> lock( _mutex );
+                    in >> _lease.first >> _lease.second;
+                    _leased = true;
+                    _cv.notify_all();
+                }
+                else if( line == "STOP" )
+                {
+                    _stopped();
+                    stop();
+                }
+            }
+
+        // gone without a STOP: the coordinator hands the lease to someone else
+        if( !_stop )
+        {
+            _lost = true;
+            _stopped();
+        }
+        stop();
+    }
+
+    // the connection dropped before the coordinator said STOP
+    bool lost() const
+    {
+        return _lost;
+    }
+
+    void beat()
+    {
+        for( int64_t last = now_ms(); !_stop; std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) ) )
+            if( now_ms() - last >= 1000 )
+            {
+                last = now_ms();
+                _conn->send_line( "HEARTBEAT " + std::to_string( _probes() ) );
+            }
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+        _stop = true;
+        _cv.notify_all();
+    }
+
+    std::unique_ptr<connection> _conn;
+    std::function<uint64_t()> _probes;
+    std::function<void()> _stopped;
+    std::thread _reader;
+    std::thread _heartbeat;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::atomic<bool> _stop;
+    std::atomic<bool> _lost;
+    bool _leased;
+    range _lease;
+};
+
+} // namespace waves_fleet
@@ -0,0 +1,633 @@
+#pragma once
+
+// in-place candidate generators: each cursor mutates one text buffer and next() only
+// touches the bytes that differ from the previous candidate; once exhausted the buffer
+// is restored, so cursors nest (the inner one runs over every state of the outer one);
+// cursors are canonical: an edit that gives the same text as an edit at a neighbouring
+// position of the same cursor kind is skipped, so a full range yields each text once
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <memory>
+
+namespace waves_gen
+{
+
+// longest text a cursor has to restore on its own
+static const size_t max_text = 1024;
+
+struct word_ref
+{
+    const char * p;
+    size_t len;
+};
+
+inline size_t word_start( const uint8_t * text, size_t len, size_t index )
+{
+    size_t pos = 0;
+    for( ; index && pos < len; pos++ )
+        if( text[pos] == ' ' )
+            index--;
+    return pos;
+}
+
+inline size_t word_end( const uint8_t * text, size_t len, size_t pos )
+{
+    while( pos < len && text[pos] != ' ' )
+        pos++;
+    return pos;
+}
+
+// every alphabet letter other than the current one at every position in [from, to)
+struct letter_substitute
+{
+    letter_substitute( uint8_t * text, size_t from, size_t to, const char * alphabet ) :
+        _text( text ), _pos( from ), _to( to ), _alphabet( alphabet ), _letter(), _saved() {}
+
+    bool next()
+    {
+        while( _pos < _to )
+        {
+            if( _letter == 0 )
+                _saved = _text[_pos];
+
+            if( _alphabet[_letter] )
+            {
+                uint8_t c = _alphabet[_letter++];
+                if( c == _saved )
+                    continue;
+
+                _text[_pos] = c;
+                return true;
+            }
+
+            _text[_pos++] = _saved;
+            _letter = 0;
+        }
+        return false;
+    }
+
+    size_t pos() const { return _pos; }
+
+    uint8_t * _text;
+    size_t _pos;
+    size_t _to;
+    const char * _alphabet;
+    size_t _letter;
+    uint8_t _saved;
+};
+
+// every alphabet letter inserted before every position in [from, to), right to left;
+// the text grows by one byte; a letter equal to the one after the slot is skipped
+// (it is the same text as that letter inserted one slot to the right)
+struct letter_insert
+{
+    letter_insert( uint8_t * text, size_t len, size_t from, size_t to, const char * alphabet ) :
+        _text( text ), _len( len ), _from( from ), _to( to ), _pos(), _alphabet( alphabet ), _letter(), _state() {}
+
+    bool next()
+    {
+        while( step() )
+            if( _pos == _len || _text[_pos] != _text[_pos + 1] )
+                return true;
+        return false;
+    }
+
+    bool step()
+    {
+        if( _state == 0 )
+        {
+            if( _from >= _to )
+                return _state = 2, false;
+
+            _state = 1;
+            _pos = _to - 1;
+            memmove( _text + _pos + 1, _text + _pos, _len - _pos );
+        }
+        else if( _state == 2 )
+            return false;
+
+        if( !_alphabet[_letter] )
+        {
+            if( _pos == _from )
+            {
+                memmove( _text + _pos, _text + _pos + 1, _len - _pos );
+                return _state = 2, false;
+            }
+
+            // the slot moves left over one original letter
+            _text[_pos] = _text[_pos - 1];
+            _pos--;
+            _letter = 0;
+        }
+
+        _text[_pos] = _alphabet[_letter++];
+        return true;
+    }
+
+    size_t pos() const { return _pos; }
+    size_t len() const { return _len + 1; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _from;
+    size_t _to;
+    size_t _pos;
+    const char * _alphabet;
+    size_t _letter;
+    int _state;
+};
+
+// every position in [from, to) deleted, right to left; the text shrinks by one byte;
+// a letter equal to the one before it is skipped (deleting that one gives the same text)
+struct letter_delete
+{
+    letter_delete( uint8_t * text, size_t len, size_t from, size_t to ) :
+        _text( text ), _len( len ), _from( from ), _to( to ), _pos(), _removed(), _state() {}
+
+    bool next()
+    {
+        while( step() )
+            if( _pos == 0 || _text[_pos - 1] != _removed )
+                return true;
+        return false;
+    }
+
+    bool step()
+    {
+        if( _state == 0 )
+        {
+            if( _from >= _to )
+                return _state = 2, false;
+
+            _state = 1;
+            _pos = _to - 1;
+            _removed = _text[_pos];
+            memmove( _text + _pos, _text + _pos + 1, _len - _pos - 1 );
+            return true;
+        }
+        else if( _state == 2 )
+            return false;
+
+        if( _pos == _from )
+        {
+            memmove( _text + _pos + 1, _text + _pos, _len - _pos - 1 );
+            _text[_pos] = _removed;
+            return _state = 2, false;
+        }
+
+        // the gap moves left: the letter before it takes the place of the removed one
+        _pos--;
+        uint8_t c = _text[_pos];
+        _text[_pos] = _removed;
+        _removed = c;
+        return true;
+    }
+
+    size_t pos() const { return _pos; }
+    size_t len() const { return _len - 1; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _from;
+    size_t _to;
+    size_t _pos;
+    uint8_t _removed;
+    int _state;
+};
+
+// words[first, last) inserted at offset at as "word " or, with tail, as " word";
+// only the word bytes change between words of equal length; a word equal to the one
+// after the insertion point is skipped (it is the same text as inserting it after that word)
+struct word_insert
+{
+    word_insert( uint8_t * text, size_t len, size_t at, bool tail, const word_ref * words, size_t first, size_t last ) :
+        _text( text ), _len( len ), _at( at ), _tail( tail ), _words( words ), _index( first ), _last( last ), _ins(),
+        _next_len( tail ? 0 : word_end( text, len, at ) - at ) {}
+
+    bool next()
+    {
+        while( _index < _last )
+        {
+            const word_ref & w = _words[_index++];
+            if( !_tail && w.len == _next_len && 0 == memcmp( w.p, _text + _at + _ins, w.len ) )
+                continue;
+
+            if( w.len + 1 != _ins )
+            {
+                memmove( _text + _at + w.len + 1, _text + _at + _ins, _len - _at );
+                _ins = w.len + 1;
+                _text[_tail ? _at : _at + w.len] = ' ';
+            }
+
+            memcpy( _text + _at + ( _tail ? 1 : 0 ), w.p, w.len );
+            return true;
+        }
+
+        if( _ins )
+        {
+            memmove( _text + _at, _text + _at + _ins, _len - _at );
+            _ins = 0;
+        }
+        return false;
+    }
+
+    size_t index() const { return _index - 1; }
+    size_t len() const { return _len + _ins; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _at;
+    bool _tail;
+    const word_ref * _words;
+    size_t _index;
+    size_t _last;
+    size_t _ins;
+    size_t _next_len;
+};
+
+// every word index in [from, to) deleted together with one adjacent space, right to left;
+// a word equal to the one before it is skipped (deleting that one gives the same text)
+struct word_delete
+{
+    word_delete( uint8_t * text, size_t len, size_t from, size_t to ) :
+        _text( text ), _len( len ), _from( from ), _index( to ), _at(), _cut(), _saved() {}
+
+    bool next()
+    {
+        restore();
+        size_t end;
+        for( ;; )
+        {
+            if( _index == _from )
+                return false;
+
+            _index--;
+            _at = word_start( _text, _len, _index );
+            end = word_end( _text, _len, _at );
+            if( _index == 0 )
+                break;
+
+            size_t prev = word_start( _text, _len, _index - 1 );
+            if( _at - 1 - prev != end - _at || memcmp( _text + prev, _text + _at, end - _at ) )
+                break;
+        }
+
+        if( end < _len )
+            end++;
+        else if( _at > 0 )
+            _at--;
+
+        _cut = end - _at;
+        memcpy( _saved, _text + _at, _cut );
+        memmove( _text + _at, _text + end, _len - end );
+        return true;
+    }
+
+    void restore()
+    {
+        if( _cut == 0 )
+            return;
+
+        memmove( _text + _at + _cut, _text + _at, _len - _at - _cut );
+        memcpy( _text + _at, _saved, _cut );
+        _cut = 0;
+    }
+
+    size_t index() const { return _index; }
+    size_t len() const { return _len - _cut; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _from;
+    size_t _index;
+    size_t _at;
+    size_t _cut;
+    uint8_t _saved[max_text];
+};
+
+// every pair of neighbouring letters starting in [from, to) swapped, left to right;
+// a pair of equal letters is skipped (swapping it gives the same text)
+struct letter_transpose
+{
+    letter_transpose( uint8_t * text, size_t len, size_t from, size_t to ) :
+        _text( text ), _len( len ), _pos( from ), _to( to < len ? to : len ? len - 1 : 0 ), _swapped() {}
+
+    bool next()
+    {
+        if( _swapped )
+        {
+            swap();
+            _pos++;
+            _swapped = false;
+        }
+
+        for( ; _pos < _to; _pos++ )
+            if( _text[_pos] != _text[_pos + 1] )
+            {
+                swap();
+                return _swapped = true;
+            }
+        return false;
+    }
+
+    void swap()
+    {
+        uint8_t c = _text[_pos];
+        _text[_pos] = _text[_pos + 1];
+        _text[_pos + 1] = c;
+    }
+
+    size_t pos() const { return _pos; }
+    size_t len() const { return _len; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _pos;
+    size_t _to;
+    bool _swapped;
+};
+
+// every letter in [from, to) typed twice, right to left; the text grows by one byte;
+// a letter equal to the one before it is skipped (doubling that one gives the same text)
+struct letter_duplicate
+{
+    letter_duplicate( uint8_t * text, size_t len, size_t from, size_t to ) :
+        _text( text ), _len( len ), _from( from ), _to( to < len ? to : len ), _pos(), _state() {}
+
+    bool next()
+    {
+        while( step() )
+            if( _pos == 0 || _text[_pos - 1] != _text[_pos] )
+                return true;
+        return false;
+    }
+
+    bool step()
+    {
+        if( _state == 0 )
+        {
+            if( _from >= _to )
+                return _state = 2, false;
+
+            _state = 1;
+            _pos = _to - 1;
+            memmove( _text + _pos + 1, _text + _pos, _len - _pos );
+            return true;
+        }
+        else if( _state == 2 )
+            return false;
+
+        if( _pos == _from )
+        {
+            memmove( _text + _pos, _text + _pos + 1, _len - _pos );
+            return _state = 2, false;
+        }
+
+        // the copy moves left: the letter before it is doubled instead
+        _pos--;
+        _text[_pos + 1] = _text[_pos];
+        return true;
+    }
+
+    size_t pos() const { return _pos; }
+    size_t len() const { return _len + 1; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _from;
+    size_t _to;
+    size_t _pos;
+    int _state;
+};
+
+// every word index in [from, to) swapped with the word after it, left to right;
+// two equal words are skipped (swapping them gives the same text)
+struct word_swap
+{
+    word_swap( uint8_t * text, size_t len, size_t from, size_t to ) :
+        _text( text ), _len( len ), _index( from ), _to( to ), _at(), _cut() {}
+
+    bool next()
+    {
+        restore();
+        for( ; _index < _to; _index++ )
+        {
+            size_t a = word_start( _text, _len, _index );
+            size_t b = word_end( _text, _len, a );
+            if( b >= _len )
+                return false;
+            size_t d = word_end( _text, _len, b + 1 );
+            if( b - a == d - b - 1 && 0 == memcmp( _text + a, _text + b + 1, b - a ) )
+                continue;
+
+            // "first second" becomes "second first"
+            _at = a;
+            _cut = d - a;
+            memcpy( _saved, _text + a, _cut );
+            memcpy( _text + a, _saved + ( b - a ) + 1, d - b - 1 );
+            _text[a + d - b - 1] = ' ';
+            memcpy( _text + a + d - b, _saved, b - a );
+            _index++;
+            return true;
+        }
+        return false;
+    }
+
+    void restore()
+    {
+        if( _cut == 0 )
+            return;
+
+        memcpy( _text + _at, _saved, _cut );
+        _cut = 0;
+    }
+
+    size_t len() const { return _len; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _index;
+    size_t _to;
+    size_t _at;
+    size_t _cut;
+    uint8_t _saved[max_text];
+};
+
+// every word index in [from, to) replaced by each of words[first, last) other than itself;
+// only the word bytes change between words of equal length
+struct word_replace
+{
+    word_replace( uint8_t * text, size_t len, size_t from, size_t to, const word_ref * words, size_t first, size_t last ) :
+        _text( text ), _len( len ), _index( from ), _to( to ), _words( words ), _first( first ), _word( first ), _last( last ),
+        _at(), _saved_len(), _cur_len(), _active() {}
+
+    bool next()
+    {
+        for( ;; )
+        {
+            if( !_active )
+            {
+                if( _index >= _to )
+                    return false;
+                _at = word_start( _text, _len, _index );
+                if( _at >= _len && _len )
+                    return false;
+                _saved_len = _cur_len = word_end( _text, _len, _at ) - _at;
+                memcpy( _saved, _text + _at, _saved_len );
+                _word = _first;
+                _active = true;
+            }
+
+            while( _word < _last )
+            {
+                const word_ref & w = _words[_word++];
+                if( w.len == _saved_len && 0 == memcmp( w.p, _saved, w.len ) )
+                    continue;
+                resize( w.len );
+                memcpy( _text + _at, w.p, w.len );
+                return true;
+            }
+
+            resize( _saved_len );
+            memcpy( _text + _at, _saved, _saved_len );
+            _active = false;
+            _index++;
+        }
+    }
+
+    void resize( size_t len )
+    {
+        if( len == _cur_len )
+            return;
+        size_t tail = _len - _at - _saved_len;
+        memmove( _text + _at + len, _text + _at + _cur_len, tail );
+        _cur_len = len;
+    }
+
+    size_t index() const { return _index; }
+    size_t len() const { return _len + _cur_len - _saved_len; }
+
+    uint8_t * _text;
+    size_t _len;
+    size_t _index;
+    size_t _to;
+    const word_ref * _words;
+    size_t _first;
+    size_t _word;
+    size_t _last;
+    size_t _at;
+    size_t _saved_len;
+    size_t _cur_len;
+    bool _active;
+    uint8_t _saved[max_text];
+};
+
+// the whole text folded to lower case, once, even when it already is
+struct case_fold
+{
+    case_fold( uint8_t * text, size_t len ) : _text( text ), _len( len ), _state() {}
+
+    bool next()
+    {
+        if( _state == 0 )
+        {
+            memcpy( _saved, _text, _len );
+            for( size_t i = 0; i < _len; i++ )
+                if( _text[i] >= 'A' && _text[i] <= 'Z' )
+                    _text[i] += 'a' - 'A';
+            return _state = 1, true;
+        }
+        if( _state == 1 )
+        {
+            memcpy( _text, _saved, _len );
+            _state = 2;
+        }
+        return false;
+    }
+
+    size_t len() const { return _len; }
+
+    uint8_t * _text;
+    size_t _len;
+    int _state;
+    uint8_t _saved[max_text];
+};
+
+inline size_t word_count( const uint8_t * text, size_t len )
+{
+    size_t n = 1;
+    for( size_t i = 0; i < len; i++ )
+        n += text[i] == ' ';
+    return n;
+}
+
+// 64-bit fingerprint of a candidate text
+inline uint64_t fingerprint( const uint8_t * p, size_t len )
+{
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ len;
+    for( ; len >= 8; p += 8, len -= 8 )
+    {
+        uint64_t v;
+        memcpy( &v, p, 8 );
+        h = ( h ^ v ) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+
+    uint64_t v = 0;
+    memcpy( &v, p, len );
+    h = ( h ^ v ) * 0xc4ceb9fe1a85ec53ULL;
+    return h ^ ( h >> 29 );
+}
+
+// lossy set of fingerprints shared by all workers, for the stages whose candidates the cursors
+// cannot make canonical (fused stages, pairs of scored edits, rules) and the stages they repeat;
+// a fingerprint lives in one bucket of 8 slots, one cache line, and only a full bucket evicts,
+// so seen() misses a duplicate only once the table holds more than its size, and never reports
+// a text it has not been given before
+struct dedupe
+{
+    static const size_t ways = 8;
+    static const size_t max_slots = (size_t)1 << 24;
+
+    struct alignas( 64 ) bucket
+    {
+        std::atomic<uint64_t> slot[ways];
+    };
+
+    // count is the number of candidates that go through seen(), the table gets about twice the slots
+    dedupe( uint64_t count ) : _mask( 127 )
+    {
+        while( ( _mask + 1 ) * ways < count * 2 && ( _mask + 1 ) * ways < max_slots )
+            _mask = _mask * 2 + 1;
+        _buckets.reset( new bucket[_mask + 1] );
+        for( size_t i = 0; i <= _mask; i++ )
+            for( auto & s : _buckets[i].slot )
+                s.store( 0, std::memory_order_relaxed );
+    }
+
+    bool seen( uint64_t h )
+    {
+        // the fingerprint of a short text is weak in its low bits, so the bucket comes from high bits
+        h |= 1;
+        bucket & b = _buckets[( h * 0x9e3779b97f4a7c15ULL >> 40 ) & _mask];
+        for( auto & s : b.slot )
+        {
+            uint64_t v = s.load( std::memory_order_relaxed );
+            if( v == 0 && s.compare_exchange_strong( v, h, std::memory_order_relaxed ) )
+                return false;
+            if( v == h )
+                return true;
+        }
+
+        // full: the top bits pick the victim
+        b.slot[h >> 61].store( h, std::memory_order_relaxed );
+        return false;
+    }
+
+    uint64_t _mask;
+    std::unique_ptr<bucket[]> _buckets;
+};
+
+} // namespace waves_gen
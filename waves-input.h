@@ -0,0 +1,195 @@
+#pragma once
+
+// candidates from outside, one per line: a file is mapped whole, stdin is read in large
+// blocks; lines are handed out as pointers into that memory and never copied on their own
+//
+// lines belong to fixed-size blocks of the input by the offset they start at, so a block
+// is a unit of work that does not depend on how the input is read or on the thread count
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace waves_input
+{
+
+static const size_t block_size = 1 << 20;
+
+// read-only view of a whole file
+struct mapping
+{
+    mapping() : _data(), _size() {}
+    mapping( const mapping & ) = delete;
+    mapping & operator=( const mapping & ) = delete;
+
+#ifdef _WIN32
+
+    bool open( const char * path )
+    {
+        HANDLE file = CreateFileA( path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+        if( file == INVALID_HANDLE_VALUE )
+            return false;
+
+        LARGE_INTEGER size;
+        bool ok = GetFileSizeEx( file, &size ) != 0;
+        _size = ok ? (size_t)size.QuadPart : 0;
+        if( ok && _size )
+        {
+            HANDLE map = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            _data = map ? (const char *)MapViewOfFile( map, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+            ok = _data != nullptr;
+            if( map )
+                CloseHandle( map );
+        }
+        CloseHandle( file );
+        return ok;
+    }
+
+    ~mapping()
+    {
+        if( _data )
+            UnmapViewOfFile( _data );
+    }
+
+#else
+
+    bool open( const char * path )
+    {
+        int fd = ::open( path, O_RDONLY );
+        if( fd < 0 )
+            return false;
+
+        struct stat st;
+        bool ok = 0 == fstat( fd, &st );
+        _size = ok ? (size_t)st.st_size : 0;
+        if( ok && _size )
+        {
+            void * p = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            ok = p != MAP_FAILED;
+            if( ok )
+            {
+                _data = (const char *)p;
+                madvise( p, _size, MADV_SEQUENTIAL );
+            }
+        }
+        ::close( fd );
+        return ok;
+    }
+
+    ~mapping()
+    {
+        if( _data )
+            munmap( (void *)_data, _size );
+    }
+
+#endif
+
+    const char * data() const { return _data; }
+    size_t size() const { return _size; }
+
+    const char * _data;
+    size_t _size;
+};
+
+// calls f( line, len ) for every line of data that starts in [begin, end), without the line
+// break; a line starting at begin > 0 counts only when data[begin - 1] ends the line before
+template <typename F>
+void lines( const char * data, size_t size, size_t begin, size_t end, F f )
+{
+    size_t pos = begin;
+    if( pos > 0 && data[pos - 1] != '\n' )
+    {
+        const char * nl = (const char *)memchr( data + pos, '\n', size - pos );
+        if( !nl )
+            return;
+        pos = nl - data + 1;
+    }
+
+    while( pos < end && pos < size )
+    {
+        const char * nl = (const char *)memchr( data + pos, '\n', size - pos );
+        size_t stop = nl ? nl - data : size;
+        size_t len = stop - pos;
+        if( len && data[pos + len - 1] == '\r' )
+            len--;
+        f( data + pos, len );
+        pos = stop + 1;
+    }
+}
+
+// whole blocks of a stream that has no size up front, such as stdin; the buffer starts one byte
+// before the first block it holds, so lines() sees whether a line starts on the block boundary
+struct stream
+{
+    stream( FILE * file ) : _file( file ), _start(), _offset(), _eof()
+    {
+#ifdef _WIN32
+        _setmode( _fileno( file ), _O_BINARY );
+#endif
+    }
+
+    // reads until the buffer holds want bytes from start() or the input ends
+    void fill( size_t want )
+    {
+        while( !_eof && _buffer.size() < _start + want )
+        {
+            size_t size = _buffer.size();
+            _buffer.resize( _start + want );
+            size_t n = fread( _buffer.data() + size, 1, _buffer.size() - size, _file );
+            _buffer.resize( size + n );
+            _eof = n == 0;
+        }
+    }
+
+    // blocks from start() whose lines all end inside the buffer
+    size_t ready() const
+    {
+        size_t size = _buffer.size() - _start;
+        if( _eof )
+            return ( size + block_size - 1 ) / block_size;
+
+        size_t last = _buffer.size();
+        while( last > _start && _buffer[last - 1] != '\n' )
+            last--;
+        return ( last - _start ) / block_size;
+    }
+
+    // forgets the first blocks, keeping the byte before the next one
+    void drop( size_t blocks )
+    {
+        size_t cut = std::min( _start + blocks * block_size, _buffer.size() ) - 1;
+        _buffer.erase( _buffer.begin(), _buffer.begin() + cut );
+        _start = 1;
+        _offset += blocks * block_size;
+    }
+
+    const char * data() const { return _buffer.data(); }
+    size_t size() const { return _buffer.size(); }
+    size_t start() const { return _start; }
+    uint64_t offset() const { return _offset; } // of start() in the stream
+    bool eof() const { return _eof; }
+
+    FILE * _file;
+    std::vector<char> _buffer;
+    size_t _start;
+    uint64_t _offset;
+    bool _eof;
+};
+
+} // namespace waves_input
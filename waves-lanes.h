@@ -0,0 +1,310 @@
+// lane-interleaved hash kernels, included by waves-simd.h inside namespace waves_simd once per
+// instruction set with WAVES_LANES_NS naming the nested namespace and WAVES_LANES_AVX2 for 256-bit vectors;
+// x86 only, WAVES_SIMD_X86
+
+#ifdef WAVES_SIMD_X86
+
+namespace WAVES_LANES_NS
+{
+
+#ifdef WAVES_LANES_AVX2
+
+typedef __m256i vec;
+static const size_t lanes32 = 8;
+static const size_t lanes64 = 4;
+
+inline vec zero() { return _mm256_setzero_si256(); }
+inline vec set1_32( uint32_t x ) { return _mm256_set1_epi32( (int)x ); }
+inline vec set1_64( uint64_t x ) { return _mm256_set1_epi64x( (long long)x ); }
+inline vec set_32( const uint32_t * x ) { return _mm256_setr_epi32( (int)x[0], (int)x[1], (int)x[2], (int)x[3], (int)x[4], (int)x[5], (int)x[6], (int)x[7] ); }
+inline vec set_64( const uint64_t * x ) { return _mm256_setr_epi64x( (long long)x[0], (long long)x[1], (long long)x[2], (long long)x[3] ); }
+inline void store( void * p, vec a ) { _mm256_storeu_si256( (vec *)p, a ); }
+inline vec add32( vec a, vec b ) { return _mm256_add_epi32( a, b ); }
+inline vec add64( vec a, vec b ) { return _mm256_add_epi64( a, b ); }
+inline vec xor_( vec a, vec b ) { return _mm256_xor_si256( a, b ); }
+inline vec or_( vec a, vec b ) { return _mm256_or_si256( a, b ); }
+inline vec and_( vec a, vec b ) { return _mm256_and_si256( a, b ); }
+inline vec andnot( vec a, vec b ) { return _mm256_andnot_si256( a, b ); }
+template <int n> inline vec rotr32( vec x ) { return _mm256_or_si256( _mm256_srli_epi32( x, n ), _mm256_slli_epi32( x, 32 - n ) ); }
+template <int n> inline vec shr32( vec x ) { return _mm256_srli_epi32( x, n ); }
+template <int n> inline vec rotl64( vec x ) { return _mm256_or_si256( _mm256_slli_epi64( x, n ), _mm256_srli_epi64( x, 64 - n ) ); }
+inline vec rotr64_32( vec x ) { return _mm256_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ); }
+inline vec rotr64_24( vec x ) { return _mm256_shuffle_epi8( x, _mm256_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10 ) ); }
+inline vec rotr64_16( vec x ) { return _mm256_shuffle_epi8( x, _mm256_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9 ) ); }
+inline vec rotr64_63( vec x ) { return _mm256_or_si256( _mm256_srli_epi64( x, 63 ), _mm256_add_epi64( x, x ) ); }
+
+#else
+
+typedef __m128i vec;
+static const size_t lanes32 = 4;
+static const size_t lanes64 = 2;
+
+inline vec zero() { return _mm_setzero_si128(); }
+inline vec set1_32( uint32_t x ) { return _mm_set1_epi32( (int)x ); }
+inline vec set1_64( uint64_t x ) { return _mm_set1_epi64x( (long long)x ); }
+inline vec set_32( const uint32_t * x ) { return _mm_setr_epi32( (int)x[0], (int)x[1], (int)x[2], (int)x[3] ); }
+inline vec set_64( const uint64_t * x ) { return _mm_set_epi64x( (long long)x[1], (long long)x[0] ); }
+inline void store( void * p, vec a ) { _mm_storeu_si128( (vec *)p, a ); }
+inline vec add32( vec a, vec b ) { return _mm_add_epi32( a, b ); }
+inline vec add64( vec a, vec b ) { return _mm_add_epi64( a, b ); }
+inline vec xor_( vec a, vec b ) { return _mm_xor_si128( a, b ); }
+inline vec or_( vec a, vec b ) { return _mm_or_si128( a, b ); }
+inline vec and_( vec a, vec b ) { return _mm_and_si128( a, b ); }
+inline vec andnot( vec a, vec b ) { return _mm_andnot_si128( a, b ); }
+template <int n> inline vec rotr32( vec x ) { return _mm_or_si128( _mm_srli_epi32( x, n ), _mm_slli_epi32( x, 32 - n ) ); }
+template <int n> inline vec shr32( vec x ) { return _mm_srli_epi32( x, n ); }
+template <int n> inline vec rotl64( vec x ) { return _mm_or_si128( _mm_slli_epi64( x, n ), _mm_srli_epi64( x, 64 - n ) ); }
+inline vec rotr64_32( vec x ) { return _mm_shuffle_epi32( x, _MM_SHUFFLE( 2, 3, 0, 1 ) ); }
+inline vec rotr64_24( vec x ) { return _mm_shuffle_epi8( x, _mm_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10 ) ); }
+inline vec rotr64_16( vec x ) { return _mm_shuffle_epi8( x, _mm_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9 ) ); }
+inline vec rotr64_63( vec x ) { return _mm_or_si128( _mm_srli_epi64( x, 63 ), _mm_add_epi64( x, x ) ); }
+
+#endif
+
+// Blake2b-256 over lanes64 inputs, the lengths may differ but must span the same number of blocks
+
+inline void blake2b_g( vec * v, int a, int b, int c, int d, vec x, vec y )
+{
+    v[a] = add64( add64( v[a], v[b] ), x );
+    v[d] = rotr64_32( xor_( v[d], v[a] ) );
+    v[c] = add64( v[c], v[d] );
+    v[b] = rotr64_24( xor_( v[b], v[c] ) );
+    v[a] = add64( add64( v[a], v[b] ), y );
+    v[d] = rotr64_16( xor_( v[d], v[a] ) );
+    v[c] = add64( v[c], v[d] );
+    v[b] = rotr64_63( xor_( v[b], v[c] ) );
+}
+
+inline void blake2b_compress( vec * h, const vec * m, vec t, bool last )
+{
+    vec v[16];
+    for( int i = 0; i < 8; i++ )
+    {
+        v[i] = h[i];
+        v[i + 8] = set1_64( blake2b_iv[i] );
+    }
+    v[12] = xor_( v[12], t );
+    if( last )
+        v[14] = xor_( v[14], set1_64( ~0ULL ) );
+
+    for( int r = 0; r < 12; r++ )
+    {
+        const uint8_t * s = blake2b_sigma[r % 10];
+        blake2b_g( v, 0, 4, 8, 12, m[s[0]], m[s[1]] );
+        blake2b_g( v, 1, 5, 9, 13, m[s[2]], m[s[3]] );
+        blake2b_g( v, 2, 6, 10, 14, m[s[4]], m[s[5]] );
+        blake2b_g( v, 3, 7, 11, 15, m[s[6]], m[s[7]] );
+        blake2b_g( v, 0, 5, 10, 15, m[s[8]], m[s[9]] );
+        blake2b_g( v, 1, 6, 11, 12, m[s[10]], m[s[11]] );
+        blake2b_g( v, 2, 7, 8, 13, m[s[12]], m[s[13]] );
+        blake2b_g( v, 3, 4, 9, 14, m[s[14]], m[s[15]] );
+    }
+
+    for( int i = 0; i < 8; i++ )
+        h[i] = xor_( h[i], xor_( v[i], v[i + 8] ) );
+}
+
+inline void blake2b256_group( const uint8_t * const * in, const size_t * len, uint8_t * const * out )
+{
+    vec h[8];
+    for( int i = 0; i < 8; i++ )
+        h[i] = set1_64( blake2b_iv[i] );
+    h[0] = xor_( h[0], set1_64( 0x01010000 ^ 32 ) );
+
+    size_t blocks = blake2b_blocks( len[0] );
+    for( size_t b = 0; b < blocks; b++ )
+    {
+        size_t off = b * 128;
+        alignas( 32 ) uint8_t block[lanes64][128];
+        const uint8_t * src[lanes64];
+        uint64_t t[lanes64];
+        for( size_t l = 0; l < lanes64; l++ )
+        {
+            size_t take = len[l] - off < 128 ? len[l] - off : 128;
+            t[l] = off + take;
+            if( take == 128 )
+                src[l] = in[l] + off;
+            else
+            {
+                memcpy( block[l], in[l] + off, take );
+                memset( block[l] + take, 0, 128 - take );
+                src[l] = block[l];
+            }
+        }
+
+        vec m[16];
+        for( int w = 0; w < 16; w++ )
+        {
+            uint64_t x[lanes64];
+            for( size_t l = 0; l < lanes64; l++ )
+                memcpy( &x[l], src[l] + w * 8, 8 );
+            m[w] = set_64( x );
+        }
+
+        blake2b_compress( h, m, set_64( t ), b + 1 == blocks );
+    }
+
+    for( int i = 0; i < 4; i++ )
+    {
+        uint64_t x[lanes64];
+        store( x, h[i] );
+        for( size_t l = 0; l < lanes64; l++ )
+            memcpy( out[l] + i * 8, &x[l], 8 );
+    }
+}
+
+inline void blake2b256( const uint8_t * const * in, const size_t * len, uint8_t * const * out )
+{
+    for( size_t g = 0; g < lanes32; g += lanes64 )
+        blake2b256_group( in + g, len + g, out + g );
+}
+
+// Keccak-256 (original padding) over lanes64 inputs of 32 bytes
+
+inline void keccak_f1600( vec * a )
+{
+    for( int r = 0; r < 24; r++ )
+    {
+        vec c[5], d[5], b[25];
+        for( int x = 0; x < 5; x++ )
+            c[x] = xor_( xor_( xor_( a[x], a[x + 5] ), xor_( a[x + 10], a[x + 15] ) ), a[x + 20] );
+        for( int x = 0; x < 5; x++ )
+            d[x] = xor_( c[( x + 4 ) % 5], rotl64<1>( c[( x + 1 ) % 5] ) );
+
+        // theta, rho and pi: lane x + 5 * y moves to y + 5 * ( ( 2 * x + 3 * y ) % 5 )
+        b[0] = xor_( a[0], d[0] );
+        b[10] = rotl64<1>( xor_( a[1], d[1] ) );
+        b[20] = rotl64<62>( xor_( a[2], d[2] ) );
+        b[5] = rotl64<28>( xor_( a[3], d[3] ) );
+        b[15] = rotl64<27>( xor_( a[4], d[4] ) );
+        b[16] = rotl64<36>( xor_( a[5], d[0] ) );
+        b[1] = rotl64<44>( xor_( a[6], d[1] ) );
+        b[11] = rotl64<6>( xor_( a[7], d[2] ) );
+        b[21] = rotl64<55>( xor_( a[8], d[3] ) );
+        b[6] = rotl64<20>( xor_( a[9], d[4] ) );
+        b[7] = rotl64<3>( xor_( a[10], d[0] ) );
+        b[17] = rotl64<10>( xor_( a[11], d[1] ) );
+        b[2] = rotl64<43>( xor_( a[12], d[2] ) );
+        b[12] = rotl64<25>( xor_( a[13], d[3] ) );
+        b[22] = rotl64<39>( xor_( a[14], d[4] ) );
+        b[23] = rotl64<41>( xor_( a[15], d[0] ) );
+        b[8] = rotl64<45>( xor_( a[16], d[1] ) );
+        b[18] = rotl64<15>( xor_( a[17], d[2] ) );
+        b[3] = rotl64<21>( xor_( a[18], d[3] ) );
+        b[13] = rotl64<8>( xor_( a[19], d[4] ) );
+        b[14] = rotl64<18>( xor_( a[20], d[0] ) );
+        b[24] = rotl64<2>( xor_( a[21], d[1] ) );
+        b[9] = rotl64<61>( xor_( a[22], d[2] ) );
+        b[19] = rotl64<56>( xor_( a[23], d[3] ) );
+        b[4] = rotl64<14>( xor_( a[24], d[4] ) );
+
+        for( int y = 0; y < 25; y += 5 )
+        for( int x = 0; x < 5; x++ )
+            a[y + x] = xor_( b[y + x], andnot( b[y + ( x + 1 ) % 5], b[y + ( x + 2 ) % 5] ) );
+
+        a[0] = xor_( a[0], set1_64( keccak_rc[r] ) );
+    }
+}
+
+inline void keccak256_32( const uint8_t * const * in, uint8_t * const * out )
+{
+    for( size_t g = 0; g < lanes32; g += lanes64 )
+    {
+        vec a[25];
+        for( int i = 0; i < 4; i++ )
+        {
+            uint64_t x[lanes64];
+            for( size_t l = 0; l < lanes64; l++ )
+                memcpy( &x[l], in[g + l] + i * 8, 8 );
+            a[i] = set_64( x );
+        }
+        a[4] = set1_64( 0x01 );
+        for( int i = 5; i < 25; i++ )
+            a[i] = zero();
+        a[16] = set1_64( 0x8000000000000000ULL );
+
+        keccak_f1600( a );
+
+        for( int i = 0; i < 4; i++ )
+        {
+            uint64_t x[lanes64];
+            store( x, a[i] );
+            for( size_t l = 0; l < lanes64; l++ )
+                memcpy( out[g + l] + i * 8, &x[l], 8 );
+        }
+    }
+}
+
+// SHA-256 over lanes32 inputs of 32 bytes
+
+inline void sha256_32( const uint8_t * const * in, uint8_t * const * out )
+{
+    vec w[64];
+    for( int i = 0; i < 8; i++ )
+    {
+        uint32_t x[lanes32];
+        for( size_t l = 0; l < lanes32; l++ )
+            x[l] = load_be32( in[l] + i * 4 );
+        w[i] = set_32( x );
+    }
+    w[8] = set1_32( 0x80000000 );
+    for( int i = 9; i < 15; i++ )
+        w[i] = zero();
+    w[15] = set1_32( 256 );
+
+    for( int i = 16; i < 64; i++ )
+    {
+        vec s0 = xor_( xor_( rotr32<7>( w[i - 15] ), rotr32<18>( w[i - 15] ) ), shr32<3>( w[i - 15] ) );
+        vec s1 = xor_( xor_( rotr32<17>( w[i - 2] ), rotr32<19>( w[i - 2] ) ), shr32<10>( w[i - 2] ) );
+        w[i] = add32( add32( w[i - 16], s0 ), add32( w[i - 7], s1 ) );
+    }
+
+    vec s[8];
+    for( int i = 0; i < 8; i++ )
+        s[i] = set1_32( sha256_h0[i] );
+
+    vec a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+    for( int i = 0; i < 64; i++ )
+    {
+        vec S1 = xor_( xor_( rotr32<6>( e ), rotr32<11>( e ) ), rotr32<25>( e ) );
+        vec ch = xor_( and_( e, f ), andnot( e, g ) );
+        vec t1 = add32( add32( add32( h, S1 ), add32( ch, set1_32( sha256_k[i] ) ) ), w[i] );
+        vec S0 = xor_( xor_( rotr32<2>( a ), rotr32<13>( a ) ), rotr32<22>( a ) );
+        vec maj = or_( and_( a, b ), and_( c, or_( a, b ) ) );
+        vec t2 = add32( S0, maj );
+        h = g;
+        g = f;
+        f = e;
+        e = add32( d, t1 );
+        d = c;
+        c = b;
+        b = a;
+        a = add32( t1, t2 );
+    }
+    s[0] = add32( s[0], a );
+    s[1] = add32( s[1], b );
+    s[2] = add32( s[2], c );
+    s[3] = add32( s[3], d );
+    s[4] = add32( s[4], e );
+    s[5] = add32( s[5], f );
+    s[6] = add32( s[6], g );
+    s[7] = add32( s[7], h );
+
+    for( int i = 0; i < 8; i++ )
+    {
+        uint32_t x[lanes32];
+        store( x, s[i] );
+        for( size_t l = 0; l < lanes32; l++ )
+            store_be32( out[l] + i * 4, x[l] );
+    }
+}
+
+inline const kernels * get()
+{
+    static const kernels k = { lanes32, blake2b256, keccak256_32, sha256_32 };
+    return &k;
+}
+
+} // namespace WAVES_LANES_NS
+
+#endif // WAVES_SIMD_X86
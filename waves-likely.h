@@ -0,0 +1,246 @@
+#pragma once
+
+// likelihood model of letter edits: every single edit of the seed gets a small integer cost,
+// roughly -log of its probability, and candidates are enumerated level by level of the total
+// cost, so the likely ones come first; the last level completes every text within k edits,
+// the pairs that drop both letters of a double included
+//
+//     0   the edit turns a token that is not a dictionary word into one
+//     1   a neighbouring key on a QWERTY keyboard, a doubled letter or a dropped double letter
+//     2   any other letter
+//     +1  the edit breaks a token that is a dictionary word
+//
+// costs of several edits add up, so the edits are treated as independent
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace waves_likely
+{
+
+static const unsigned max_cost = 3;
+
+enum kind : uint8_t { substitute, insert, erase };
+
+struct edit
+{
+    uint32_t pos; // in the original text, an insert goes before pos
+    uint8_t kind;
+    uint8_t letter;
+    uint8_t cost;
+
+    // edits with the same key are never combined, insert before pos sorts before pos itself
+    uint32_t key() const { return kind == insert ? pos * 2 : pos * 2 + 1; }
+    int shift() const { return kind == insert ? 1 : kind == erase ? -1 : 0; }
+};
+
+// neighbours on a QWERTY keyboard, each row is shifted right by half a key from the one above;
+// the space bar lies under c to m
+inline bool adjacent( uint8_t a, uint8_t b )
+{
+    static const char * rows[] = { "qwertyuiop", "asdfghjkl", "zxcvbnm" };
+    if( a == ' ' || b == ' ' )
+        return ( a == ' ' ? b : a ) != ' ' && strchr( "cvbnm", a == ' ' ? b : a ) != nullptr;
+
+    int ra = -1, ca = 0, rb = -1, cb = 0;
+    for( int r = 0; r < 3; r++ )
+    {
+        if( const char * p = strchr( rows[r], a ) )
+            ra = r, ca = (int)( p - rows[r] );
+        if( const char * p = strchr( rows[r], b ) )
+            rb = r, cb = (int)( p - rows[r] );
+    }
+    if( ra < 0 || rb < 0 || !a || !b )
+        return false;
+    if( ra == rb )
+        return ca - cb == 1 || cb - ca == 1;
+    if( ra > rb )
+        std::swap( ra, rb ), std::swap( ca, cb );
+    return rb == ra + 1 && ( cb == ca || cb == ca - 1 );
+}
+
+// applies e to text of len bytes at pos, where pos is e.pos moved by the edits applied before;
+// returns the new length, saved keeps what undo() needs
+inline size_t apply( uint8_t * text, size_t len, size_t pos, const edit & e, uint8_t & saved )
+{
+    switch( e.kind )
+    {
+        case substitute:
+            saved = text[pos];
+            text[pos] = e.letter;
+            return len;
+        case insert:
+            memmove( text + pos + 1, text + pos, len - pos );
+            text[pos] = e.letter;
+            return len + 1;
+        default:
+            saved = text[pos];
+            memmove( text + pos, text + pos + 1, len - pos - 1 );
+            return len - 1;
+    }
+}
+
+// reverts apply(), len is the length apply() returned
+inline size_t undo( uint8_t * text, size_t len, size_t pos, const edit & e, uint8_t saved )
+{
+    switch( e.kind )
+    {
+        case substitute:
+            text[pos] = saved;
+            return len;
+        case insert:
+            memmove( text + pos, text + pos + 1, len - pos - 1 );
+            return len - 1;
+        default:
+            memmove( text + pos + 1, text + pos, len - pos );
+            text[pos] = saved;
+            return len + 1;
+    }
+}
+
+// every canonical single edit of one text, as the waves-gen cursors make them, cheapest first
+struct model
+{
+    void build( const uint8_t * text, size_t len, const char * alphabet, const std::unordered_set<std::string> & words )
+    {
+        _text.assign( (const char *)text, len );
+        _words = &words;
+        edits.clear();
+
+        for( size_t pos = 0; pos <= len; pos++ )
+        {
+            for( const char * c = alphabet; *c; c++ )
+            {
+                if( pos < len && (uint8_t)*c != text[pos] )
+                    add( { (uint32_t)pos, substitute, (uint8_t)*c, 0 } );
+                if( pos == len || (uint8_t)*c != text[pos] )
+                    add( { (uint32_t)pos, insert, (uint8_t)*c, 0 } );
+            }
+            if( pos < len && ( pos == 0 || text[pos] != text[pos - 1] ) )
+                add( { (uint32_t)pos, erase, 0, 0 } );
+        }
+
+        std::stable_sort( edits.begin(), edits.end(), []( const edit & a, const edit & b ) { return a.cost < b.cost; } );
+        for( unsigned c = 0; c <= max_cost + 1; c++ )
+            first[c] = std::lower_bound( edits.begin(), edits.end(), c, []( const edit & e, unsigned v ) { return e.cost < v; } ) - edits.begin();
+    }
+
+    // edits of cost c are [first[c], first[c + 1])
+    size_t bucket( unsigned c ) const { return first[std::min( c, max_cost + 1 )]; }
+
+    // e erases the first letter of a run of two or more
+    bool run_erase( const edit & e ) const
+    {
+        return e.kind == erase && e.pos + 1 < _text.size() && _text[e.pos + 1] == _text[e.pos];
+    }
+
+    // every candidate of total cost c whose first edit is edits[i], paired with a later edit
+    // when pairs is set; text holds the original with room for two more letters and is
+    // restored afterwards, probe( len ) sees each candidate in place
+    template <typename F>
+    void each( uint8_t * text, bool pairs, unsigned c, size_t i, F probe ) const
+    {
+        const edit & e1 = edits[i];
+        if( e1.cost > c || ( !pairs && e1.cost != c ) )
+            return;
+
+        uint8_t saved1 = 0, saved2 = 0;
+        size_t len = apply( text, _text.size(), e1.pos, e1, saved1 );
+        if( e1.cost == c )
+            probe( len );
+
+        auto probe2 = [&]( const edit & e2, size_t pos )
+        {
+            size_t len2 = apply( text, len, pos, e2, saved2 );
+            probe( len2 );
+            undo( text, len2, pos, e2, saved2 );
+        };
+
+        // pairs are unordered, the second edit comes later in the cost order
+        unsigned rest = c - e1.cost;
+        if( pairs && rest >= e1.cost )
+        {
+            // the same letter twice into one slot, or both of a double letter dropped
+            if( ( e1.kind == insert || run_erase( e1 ) ) && rest == e1.cost )
+                probe2( e1, e1.pos );
+
+            for( size_t j = std::max( bucket( rest ), i + 1 ), end = bucket( rest + 1 ); j < end; j++ )
+            {
+                const edit & e2 = edits[j];
+                if( e2.key() != e1.key() )
+                    probe2( e2, e2.pos + ( e2.key() > e1.key() ? e1.shift() : 0 ) );
+                else if( e2.kind == insert )
+                {
+                    // two letters into one slot, in both orders
+                    probe2( e2, e2.pos );
+                    probe2( e2, e2.pos + 1 );
+                }
+            }
+        }
+
+        undo( text, len, e1.pos, e1, saved1 );
+    }
+
+    void add( edit e )
+    {
+        uint8_t prev = e.pos > 0 ? _text[e.pos - 1] : 0;
+        uint8_t here = e.pos < _text.size() ? _text[e.pos] : 0;
+        uint8_t next = e.pos + 1 < _text.size() ? _text[e.pos + 1] : 0;
+
+        bool before = valid( _text, e.pos );
+        std::string edited = _text;
+        if( e.kind == substitute )
+            edited[e.pos] = e.letter;
+        else if( e.kind == insert )
+            edited.insert( edited.begin() + e.pos, e.letter );
+        else
+            edited.erase( e.pos, 1 );
+        bool after = valid( edited, std::min<size_t>( e.pos, edited.size() ) );
+
+        bool near;
+        if( e.kind == substitute )
+            near = adjacent( here, e.letter );
+        else if( e.kind == insert )
+            near = e.letter == prev || e.letter == here || adjacent( e.letter, prev ) || adjacent( e.letter, here );
+        else
+            near = here == next || adjacent( here, prev ) || adjacent( here, next );
+
+        e.cost = after && !before ? 0 : near ? 1 : 2;
+        if( before && !after )
+            e.cost++;
+        edits.push_back( e );
+    }
+
+    // every token at pos or running into it from the left is a word
+    bool valid( const std::string & text, size_t pos ) const
+    {
+        size_t begin = pos;
+        while( begin > 0 && text[begin - 1] != ' ' )
+            begin--;
+        size_t end = std::min( pos + 1, text.size() );
+        while( end < text.size() && text[end] != ' ' )
+            end++;
+
+        for( size_t i = begin; i <= end; )
+        {
+            size_t j = text.find( ' ', i );
+            if( j == std::string::npos || j > end )
+                j = end;
+            if( !_words->count( text.substr( i, j - i ) ) )
+                return false;
+            i = j + 1;
+        }
+        return true;
+    }
+
+    std::vector<edit> edits;
+    size_t first[max_cost + 2];
+    std::string _text;
+    const std::unordered_set<std::string> * _words;
+};
+
+} // namespace waves_likely
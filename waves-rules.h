@@ -0,0 +1,236 @@
+#pragma once
+
+// a small rule language over the waves-gen cursors, in the spirit of hashcat rules:
+//
+//     T   transpose two neighbouring letters
+//     D   type a letter twice
+//     S   swap two neighbouring words
+//     X   drop a word
+//     R   replace a word with a dict word
+//     L   fold the seed to lower case
+//
+// an op may be followed by a 0-based position (X3 drops the fourth word), without one it
+// runs over every position; a rule chains up to max_depth ops ("TS" transposes letters in
+// every text the swap makes) and --rules takes a comma separated list of rules
+//
+// a chain is compiled once into kernel<K...>, which nests the cursors of its ops directly,
+// so a chain costs no more per candidate than the hand-written strategy loops
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "waves-gen.h"
+
+namespace waves_rules
+{
+
+static const size_t max_depth = 3;
+static const size_t every = (size_t)-1;
+
+enum kind { transpose, duplicate, swap_words, drop_word, replace_word, fold_case };
+
+static const char names[] = "TDSXRL";
+
+struct op
+{
+    kind k;
+    size_t pos; // every for all positions
+};
+
+struct rule
+{
+    std::string text;
+    std::vector<op> ops;
+};
+
+// the dict words R replaces with
+struct context
+{
+    const waves_gen::word_ref * words;
+    size_t count;
+};
+
+// parses "rule,rule,...", false with error set on a bad rule
+inline bool parse( const std::string & spec, std::vector<rule> & rules, std::string & error )
+{
+    for( size_t begin = 0; begin <= spec.size(); )
+    {
+        size_t end = spec.find( ',', begin );
+        if( end == std::string::npos )
+            end = spec.size();
+
+        rule r;
+        r.text = spec.substr( begin, end - begin );
+        for( size_t i = 0; i < r.text.size(); )
+        {
+            const char * name = strchr( names, r.text[i] );
+            if( !name || !*name )
+                return error = "unknown op '" + r.text.substr( i, 1 ) + "' in rule \"" + r.text + "\"", false;
+
+            // digits only, so a sign or a space is an unknown op rather than a position
+            op o = { (kind)( name - names ), every };
+            size_t digits = i + 1;
+            for( ; digits < r.text.size() && isdigit( (unsigned char)r.text[digits] ); digits++ )
+            {
+                size_t d = r.text[digits] - '0';
+                if( o.pos == every )
+                    o.pos = 0;
+                if( o.pos > ( every - 1 - d ) / 10 )
+                    return error = "bad position '" + r.text.substr( i + 1, r.text.find_first_not_of( "0123456789", i + 1 ) - i - 1 ) + "' in rule \"" + r.text + "\"", false;
+                o.pos = o.pos * 10 + d;
+            }
+            i = digits;
+            r.ops.push_back( o );
+        }
+
+        if( r.ops.empty() || r.ops.size() > max_depth )
+            return error = "rule \"" + r.text + "\" needs 1 to " + std::to_string( max_depth ) + " ops", false;
+        rules.push_back( r );
+        begin = end + 1;
+    }
+    return true;
+}
+
+// the cursors behind the ops, with one constructor and the number of positions they run over
+template <kind K> struct cursor;
+
+template <> struct cursor<transpose> : waves_gen::letter_transpose
+{
+    cursor( uint8_t * text, size_t len, size_t from, size_t to, const context & ) : letter_transpose( text, len, from, to ) {}
+    static size_t positions( const uint8_t *, size_t len ) { return len; }
+};
+
+template <> struct cursor<duplicate> : waves_gen::letter_duplicate
+{
+    cursor( uint8_t * text, size_t len, size_t from, size_t to, const context & ) : letter_duplicate( text, len, from, to ) {}
+    static size_t positions( const uint8_t *, size_t len ) { return len; }
+};
+
+template <> struct cursor<swap_words> : waves_gen::word_swap
+{
+    cursor( uint8_t * text, size_t len, size_t from, size_t to, const context & ) : word_swap( text, len, from, to ) {}
+    static size_t positions( const uint8_t * text, size_t len ) { return waves_gen::word_count( text, len ); }
+};
+
+template <> struct cursor<drop_word> : waves_gen::word_delete
+{
+    cursor( uint8_t * text, size_t len, size_t from, size_t to, const context & ) : word_delete( text, len, from, to ) {}
+    static size_t positions( const uint8_t * text, size_t len ) { return waves_gen::word_count( text, len ); }
+};
+
+template <> struct cursor<replace_word> : waves_gen::word_replace
+{
+    cursor( uint8_t * text, size_t len, size_t from, size_t to, const context & c ) : word_replace( text, len, from, to, c.words, 0, c.count ) {}
+    static size_t positions( const uint8_t * text, size_t len ) { return waves_gen::word_count( text, len ); }
+};
+
+template <> struct cursor<fold_case> : waves_gen::case_fold
+{
+    cursor( uint8_t * text, size_t len, size_t, size_t, const context & ) : case_fold( text, len ) {}
+    static size_t positions( const uint8_t *, size_t ) { return 1; }
+};
+
+// upper bound of the texts r makes from a text of the given letters and words, with dict words
+// of up to longest letters; a D makes one more letter and maybe one more word (a doubled
+// space), an R up to longest more letters, and the ops after them run over those
+inline uint64_t estimate( const rule & r, size_t letters, size_t words, size_t dict, size_t longest )
+{
+    uint64_t n = 1;
+    for( auto & o : r.ops )
+    {
+        bool one = o.pos != every;
+        switch( o.k )
+        {
+            case transpose: n *= one ? 1 : letters; break;
+            case duplicate: n *= one ? 1 : letters; letters++; words++; break;
+            case swap_words: case drop_word: n *= one ? 1 : words; break;
+            case replace_word: n *= ( one ? 1 : words ) * (uint64_t)dict; letters += longest; break;
+            case fold_case: break;
+        }
+    }
+    return n;
+}
+
+// positions of o in a text with the given number of them, or only position block of them
+inline void range( const op & o, size_t positions, size_t block, size_t & from, size_t & to )
+{
+    from = o.pos != every ? o.pos : block != every ? block : 0;
+    to = o.pos != every || block != every ? from + 1 : positions;
+    if( to > positions )
+        to = positions;
+    if( from > to )
+        from = to;
+}
+
+// every text of the chain K... over text, probe( len ) sees each one in place
+template <kind... K> struct kernel;
+
+template <> struct kernel<>
+{
+    template <typename P>
+    static void run( uint8_t *, size_t len, const op *, size_t, const context &, P & probe )
+    {
+        probe( len );
+    }
+};
+
+template <kind K, kind... Rest> struct kernel<K, Rest...>
+{
+    template <typename P>
+    static void run( uint8_t * text, size_t len, const op * ops, size_t block, const context & c, P & probe )
+    {
+        size_t from, to;
+        range( *ops, cursor<K>::positions( text, len ), block, from, to );
+        cursor<K> cur( text, len, from, to, c );
+        while( cur.next() )
+            kernel<Rest...>::run( text, cur.len(), ops + 1, every, c, probe );
+    }
+};
+
+// T<K...>::run of the kinds of ops, picked once per rule; the pack grows one kind per level
+template <typename F, template <kind...> class T, bool deeper, kind... K> struct compiler;
+
+template <typename F, template <kind...> class T, kind... K> struct compiler<F, T, false, K...>
+{
+    static F get( const op *, size_t n )
+    {
+        return n == 0 ? &T<K...>::run : nullptr;
+    }
+};
+
+template <typename F, template <kind...> class T, kind... K> struct compiler<F, T, true, K...>
+{
+    template <kind N>
+    static F next( const op * ops, size_t n )
+    {
+        return compiler<F, T, ( sizeof...( K ) + 1 < max_depth ), K..., N>::get( ops + 1, n - 1 );
+    }
+
+    static F get( const op * ops, size_t n )
+    {
+        if( n == 0 )
+            return &T<K...>::run;
+
+        switch( ops->k )
+        {
+            case transpose: return next<transpose>( ops, n );
+            case duplicate: return next<duplicate>( ops, n );
+            case swap_words: return next<swap_words>( ops, n );
+            case drop_word: return next<drop_word>( ops, n );
+            case replace_word: return next<replace_word>( ops, n );
+            case fold_case: return next<fold_case>( ops, n );
+        }
+        return nullptr;
+    }
+};
+
+template <typename F, template <kind...> class T>
+F compile( const rule & r )
+{
+    return compiler<F, T, true>::get( r.ops.data(), r.ops.size() );
+}
+
+} // namespace waves_rules
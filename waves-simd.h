@@ -0,0 +1,207 @@
+#pragma once
+
+// multi-buffer Blake2b-256, Keccak-256 and SHA-256 over a batch of equal-length candidates
+
+#include <cstdint>
+#include <cstring>
+
+// the SSE4.1 and AVX2 kernels exist on x86 only, elsewhere every batch takes the scalar path
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 )
+#define WAVES_SIMD_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace waves_simd
+{
+
+// hashes kernels::lanes inputs per call, in and out may alias
+struct kernels
+{
+    size_t lanes;
+    void ( *blake2b256 )( const uint8_t * const * in, const size_t * len, uint8_t * const * out );
+    void ( *keccak256_32 )( const uint8_t * const * in, uint8_t * const * out );
+    void ( *sha256_32 )( const uint8_t * const * in, uint8_t * const * out );
+};
+
+enum isa { isa_none, isa_sse41, isa_avx2 };
+
+static const size_t max_lanes = 8;
+static const size_t len32[max_lanes] = { 32, 32, 32, 32, 32, 32, 32, 32 };
+
+// inputs batched into one blake2b256 call must agree on this
+inline size_t blake2b_blocks( size_t len )
+{
+    return len ? ( len + 127 ) / 128 : 1;
+}
+
+static const uint64_t blake2b_iv[8] =
+{
+    0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+    0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+};
+
+static const uint8_t blake2b_sigma[10][16] =
+{
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+    { 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+    { 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+    { 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+    { 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+    { 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+    { 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+    { 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+    { 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+};
+
+static const uint64_t keccak_rc[24] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL,
+};
+
+static const uint32_t sha256_h0[8] =
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static const uint32_t sha256_k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t load_be32( const uint8_t * p )
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3];
+}
+
+inline void store_be32( uint8_t * p, uint32_t x )
+{
+    p[0] = (uint8_t)( x >> 24 );
+    p[1] = (uint8_t)( x >> 16 );
+    p[2] = (uint8_t)( x >> 8 );
+    p[3] = (uint8_t)x;
+}
+
+} // namespace waves_simd
+
+#ifdef WAVES_SIMD_X86
+
+// each instruction set gets its own copy of waves-lanes.h compiled for that target
+
+#if defined( __clang__ )
+#pragma clang attribute push( __attribute__( ( target( "sse4.1,ssse3" ) ) ), apply_to = function )
+#elif defined( __GNUC__ )
+#pragma GCC push_options
+#pragma GCC target( "sse4.1,ssse3" )
+#endif
+#define WAVES_LANES_NS sse41
+namespace waves_simd
+{
+#include "waves-lanes.h"
+}
+#undef WAVES_LANES_NS
+#if defined( __clang__ )
+#pragma clang attribute pop
+#elif defined( __GNUC__ )
+#pragma GCC pop_options
+#endif
+
+#if defined( __clang__ )
+#pragma clang attribute push( __attribute__( ( target( "avx2" ) ) ), apply_to = function )
+#elif defined( __GNUC__ )
+#pragma GCC push_options
+#pragma GCC target( "avx2" )
+#endif
+#define WAVES_LANES_NS avx2
+#define WAVES_LANES_AVX2
+namespace waves_simd
+{
+#include "waves-lanes.h"
+}
+#undef WAVES_LANES_AVX2
+#undef WAVES_LANES_NS
+#if defined( __clang__ )
+#pragma clang attribute pop
+#elif defined( __GNUC__ )
+#pragma GCC pop_options
+#endif
+
+#endif // WAVES_SIMD_X86
+
+namespace waves_simd
+{
+
+inline isa detect()
+{
+#if !defined( WAVES_SIMD_X86 )
+    return isa_none;
+#elif defined( _MSC_VER )
+    int r[4];
+    __cpuid( r, 0 );
+    int leaves = r[0];
+
+    __cpuid( r, 1 );
+    bool sse41 = ( r[2] & ( 1 << 19 ) ) != 0;
+    bool osxsave = ( r[2] & ( 1 << 27 ) ) != 0;
+    bool avx = ( r[2] & ( 1 << 28 ) ) != 0;
+    bool avx2 = false;
+    if( leaves >= 7 )
+    {
+        __cpuidex( r, 7, 0 );
+        avx2 = ( r[1] & ( 1 << 5 ) ) != 0;
+    }
+    if( avx2 && avx && osxsave && ( _xgetbv( 0 ) & 6 ) == 6 )
+        return isa_avx2;
+    return sse41 ? isa_sse41 : isa_none;
+#else
+    __builtin_cpu_init();
+    if( __builtin_cpu_supports( "avx2" ) )
+        return isa_avx2;
+    if( __builtin_cpu_supports( "sse4.1" ) )
+        return isa_sse41;
+    return isa_none;
+#endif
+}
+
+// nullptr means the scalar fixed-length path
+inline const kernels * select( isa i )
+{
+#ifdef WAVES_SIMD_X86
+    switch( i )
+    {
+        case isa_avx2: return avx2::get();
+        case isa_sse41: return sse41::get();
+        default: return nullptr;
+    }
+#else
+    (void)i;
+    return nullptr;
+#endif
+}
+
+inline const char * isa_name( isa i )
+{
+    switch( i )
+    {
+        case isa_avx2: return "avx2";
+        case isa_sse41: return "sse4.1";
+        default: return "none";
+    }
+}
+
+} // namespace waves_simd
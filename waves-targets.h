@@ -0,0 +1,96 @@
+#pragma once
+
+// set of 20-byte address hashes the search looks for
+//
+// open addressing over the first 8 bytes of each hash, which are uniformly random already;
+// a probe reads one 16-byte slot in the common miss case and only compares the full
+// 20 bytes when those 8 bytes match, so its cost does not grow with the number of targets
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace waves_targets
+{
+
+static const size_t npos = (size_t)-1;
+
+struct table
+{
+    table() : _mask(), _slots( 1 ) {}
+
+    // index of hash among the added ones, npos if it is already there
+    size_t add( const uint8_t * hash )
+    {
+        if( find( hash ) != npos )
+            return npos;
+
+        _hashes.emplace_back();
+        memcpy( _hashes.back().bytes, hash, 20 );
+        if( _hashes.size() * 2 > _slots.size() )
+            rehash( _slots.size() * 2 );
+        else
+            insert( _hashes.size() - 1 );
+        return _hashes.size() - 1;
+    }
+
+    size_t find( const uint8_t * hash ) const
+    {
+        uint64_t prefix = load( hash );
+        for( size_t i = prefix & _mask;; i = ( i + 1 ) & _mask )
+        {
+            const slot & s = _slots[i];
+            if( s.index == 0 )
+                return npos;
+            if( s.prefix == prefix && 0 == memcmp( _hashes[s.index - 1].bytes + 8, hash + 8, 12 ) )
+                return s.index - 1;
+        }
+    }
+
+    size_t size() const
+    {
+        return _hashes.size();
+    }
+
+    struct slot
+    {
+        uint64_t prefix;
+        uint64_t index; // 1-based, 0 for an empty slot
+    };
+
+    struct hash20
+    {
+        uint8_t bytes[20];
+    };
+
+    static uint64_t load( const uint8_t * hash )
+    {
+        uint64_t prefix;
+        memcpy( &prefix, hash, 8 );
+        return prefix;
+    }
+
+    void insert( size_t index )
+    {
+        uint64_t prefix = load( _hashes[index].bytes );
+        size_t i = prefix & _mask;
+        while( _slots[i].index )
+            i = ( i + 1 ) & _mask;
+        _slots[i].prefix = prefix;
+        _slots[i].index = index + 1;
+    }
+
+    void rehash( size_t size )
+    {
+        _slots.assign( size, slot() );
+        _mask = size - 1;
+        for( size_t i = 0; i < _hashes.size(); i++ )
+            insert( i );
+    }
+
+    uint64_t _mask;
+    std::vector<slot> _slots;
+    std::vector<hash20> _hashes;
+};
+
+} // namespace waves_targets
@@ -1,58 +1,178 @@
-#include <windows.h>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include <b58.c>
 
-#include <botan\blake2b.h>
-#include <botan\keccak.h>
-#include <botan\sha2_32.h>
+#ifdef _MSC_VER
 #pragma warning( push )
 #pragma warning( disable : 4250 ) // inherits via dominance
-#include <botan\curve25519.h>
+#endif
+#include <botan/curve25519.h>
+#ifdef _MSC_VER
 #pragma warning( pop )
+#endif
+
+#include "waves-crypto.h"
+#include "waves-address.h"
+#include "waves-gen.h"
+#include "waves-likely.h"
+#include "waves-words.h"
+#include "waves-input.h"
+#include "waves-rules.h"
+#include "waves-targets.h"
+#include "waves-checkpoint.h"
+#include "waves-fleet.h"
+
+static waves_targets::table g_targets;
+static std::vector<std::string> g_addresses;
+static std::unique_ptr<std::atomic<bool>[]> g_hits;
+static const uint8_t g_base9[32] = { 9 };
+static const waves_simd::kernels * g_simd;
+
+
+static waves_crypto g_waves_crypto;
+static uint32_t g_nonce; // the 4-byte prefix every candidate is hashed behind
+static uint8_t g_chain = waves_address::mainnet;
+const char g_english[] = "abcdefghijklmnopqrstuvwxyz ";
 
-__declspec( align( 128 ) ) static uint8_t g_pubsechash[128];
+#define DICTFULL { "abandon", "ability", "able", "about", "above", "absent", "absorb", "abstract", "absurd", "abuse", "access", "accident", "account", "accuse", "achieve", "acid", "acoustic", "acquire", "across", "act", "action", "actor", "actress", "actual", "adapt", "add", "addict", "address", "adjust", "admit", "adult", "advance", "advice", "aerobic", "affair", "afford", "afraid", "again", "age", "agent", "agree", "ahead", "aim", "air", "airport", "aisle", "alarm", "album", "alcohol", "alert", "alien", "all", "alley", "allow", "almost", "alone", "alpha", "already", "also", "alter", "always", "amateur", "amazing", "among", "amount", "amused", "analyst", "anchor", "ancient", "anger", "angle", "angry", "animal", "ankle", "announce", "annual", "another", "answer", "antenna", "antique", "anxiety", "any", "apart", "apology", "appear", "apple", "approve", "april", "arch", "arctic", "area", "arena", "argue", "arm", "armed", "armor", "army", "around", "arrange", "arrest", "arrive", "arrow", "art", "artefact", "artist", "artwork", "ask", "aspect", "assault", "asset", "assist", "assume", "asthma", "athlete", "atom", "attack", "attend", "attitude", "attract", "auction", "audit", "august", "aunt", "author", "auto", "autumn", "average", "avocado", "avoid", "awake", "aware", "away", "awesome", "awful", "awkward", "axis", "baby", "bachelor", "bacon", "badge", "bag", "balance", "balcony", "ball", "bamboo", "banana", "banner", "bar", "barely", "bargain", "barrel", "base", "basic", "basket", "battle", "beach", "bean", "beauty", "because", "become", "beef", "before", "begin", "behave", "behind", "believe", "below", "belt", "bench", "benefit", "best", "betray", "better", "between", "beyond", "bicycle", "bid", "bike", "bind", "biology", "bird", "birth", "bitter", "black", "blade", "blame", "blanket", "blast", "bleak", "bless", "blind", "blood", "blossom", "blouse", "blue", "blur", "blush", "board", "boat", "body", "boil", "bomb", "bone", "bonus", "book", "boost", "border", "boring", "borrow", "boss", "bottom", "bounce", "box", "boy", "bracket", "brain", "brand", "brass", "brave", "bread", "breeze", "brick", "bridge", "brief", "bright", "bring", "brisk", "broccoli", "broken", "bronze", "broom", "brother", "brown", "brush", "bubble", "buddy", "budget", "buffalo", "build", "bulb", "bulk", "bullet", "bundle", "bunker", "burden", "burger", "burst", "bus", "business", "busy", "butter", "buyer", "buzz", "cabbage", "cabin", "cable", "cactus", "cage", "cake", "call", "calm", "camera", "camp", "can", "canal", "cancel", "candy", "cannon", "canoe", "canvas", "canyon", "capable", "capital", "captain", "car", "carbon", "card", "cargo", "carpet", "carry", "cart", "case", "cash", "casino", "castle", "casual", "cat", "catalog", "catch", "category", "cattle", "caught", "cause", "caution", "cave", "ceiling", "celery", "cement", "census", "century", "cereal", "certain", "chair", "chalk", "champion", "change", "chaos", "chapter", "charge", "chase", "chat", "cheap", "check", "cheese", "chef", "cherry", "chest", "chicken", "chief", "child", "chimney", "choice", "choose", "chronic", "chuckle", "chunk", "churn", "cigar", "cinnamon", "circle", "citizen", "city", "civil", "claim", "clap", "clarify", "claw", "clay", "clean", "clerk", "clever", "click", "client", "cliff", "climb", "clinic", "clip", "clock", "clog", "close", "cloth", "cloud", "clown", "club", "clump", "cluster", "clutch", "coach", "coast", "coconut", "code", "coffee", "coil", "coin", "collect", "color", "column", "combine", "come", "comfort", "comic", "common", "company", "concert", "conduct", "confirm", "congress", "connect", "consider", "control", "convince", "cook", "cool", "copper", "copy", "coral", "core", "corn", "correct", "cost", "cotton", "couch", "country", "couple", "course", "cousin", "cover", "coyote", "crack", "cradle", "craft", "cram", "crane", "crash", "crater", "crawl", "crazy", "cream", "credit", "creek", "crew", "cricket", "crime", "crisp", "critic", "crop", "cross", "crouch", "crowd", "crucial", "cruel", "cruise", "crumble", "crunch", "crush", "cry", "crystal", "cube", "culture", "cup", "cupboard", "curious", "current", "curtain", "curve", "cushion", "custom", "cute", "cycle", "dad", "damage", "damp", "dance", "danger", "daring", "dash", "daughter", "dawn", "day", "deal", "debate", "debris", "decade", "december", "decide", "decline", "decorate", "decrease", "deer", "defense", "define", "defy", "degree", "delay", "deliver", "demand", "demise", "denial", "dentist", "deny", "depart", "depend", "deposit", "depth", "deputy", "derive", "describe", "desert", "design", "desk", "despair", "destroy", "detail", "detect", "develop", "device", "devote", "diagram", "dial", "diamond", "diary", "dice", "diesel", "diet", "differ", "digital", "dignity", "dilemma", "dinner", "dinosaur", "direct", "dirt", "disagree", "discover", "disease", "dish", "dismiss", "disorder", "display", "distance", "divert", "divide", "divorce", "dizzy", "doctor", "document", "dog", "doll", "dolphin", "domain", "donate", "donkey", "donor", "door", "dose", "double", "dove", "draft", "dragon", "drama", "drastic", "draw", "dream", "dress", "drift", "drill", "drink", "drip", "drive", "drop", "drum", "dry", "duck", "dumb", "dune", "during", "dust", "dutch", "duty", "dwarf", "dynamic", "eager", "eagle", "early", "earn", "earth", "easily", "east", "easy", "echo", "ecology", "economy", "edge", "edit", "educate", "effort", "egg", "eight", "either", "elbow", "elder", "electric", "elegant", "element", "elephant", "elevator", "elite", "else", "embark", "embody", "embrace", "emerge", "emotion", "employ", "empower", "empty", "enable", "enact", "end", "endless", "endorse", "enemy", "energy", "enforce", "engage", "engine", "enhance", "enjoy", "enlist", "enough", "enrich", "enroll", "ensure", "enter", "entire", "entry", "envelope", "episode", "equal", "equip", "era", "erase", "erode", "erosion", "error", "erupt", "escape", "essay", "essence", "estate", "eternal", "ethics", "evidence", "evil", "evoke", "evolve", "exact", "example", "excess", "exchange", "excite", "exclude", "excuse", "execute", "exercise", "exhaust", "exhibit", "exile", "exist", "exit", "exotic", "expand", "expect", "expire", "explain", "expose", "express", "extend", "extra", "eye", "eyebrow", "fabric", "face", "faculty", "fade", "faint", "faith", "fall", "false", "fame", "family", "famous", "fan", "fancy", "fantasy", "farm", "fashion", "fat", "fatal", "father", "fatigue", "fault", "favorite", "feature", "february", "federal", "fee", "feed", "feel", "female", "fence", "festival", "fetch", "fever", "few", "fiber", "fiction", "field", "figure", "file", "film", "filter", "final", "find", "fine", "finger", "finish", "fire", "firm", "first", "fiscal", "fish", "fit", "fitness", "fix", "flag", "flame", "flash", "flat", "flavor", "flee", "flight", "flip", "float", "flock", "floor", "flower", "fluid", "flush", "fly", "foam", "focus", "fog", "foil", "fold", "follow", "food", "foot", "force", "forest", "forget", "fork", "fortune", "forum", "forward", "fossil", "foster", "found", "fox", "fragile", "frame", "frequent", "fresh", "friend", "fringe", "frog", "front", "frost", "frown", "frozen", "fruit", "fuel", "fun", "funny", "furnace", "fury", "future", "gadget", "gain", "galaxy", "gallery", "game", "gap", "garage", "garbage", "garden", "garlic", "garment", "gas", "gasp", "gate", "gather", "gauge", "gaze", "general", "genius", "genre", "gentle", "genuine", "gesture", "ghost", "giant", "gift", "giggle", "ginger", "giraffe", "girl", "give", "glad", "glance", "glare", "glass", "glide", "glimpse", "globe", "gloom", "glory", "glove", "glow", "glue", "goat", "goddess", "gold", "good", "goose", "gorilla", "gospel", "gossip", "govern", "gown", "grab", "grace", "grain", "grant", "grape", "grass", "gravity", "great", "green", "grid", "grief", "grit", "grocery", "group", "grow", "grunt", "guard", "guess", "guide", "guilt", "guitar", "gun", "gym", "habit", "hair", "half", "hammer", "hamster", "hand", "happy", "harbor", "hard", "harsh", "harvest", "hat", "have", "hawk", "hazard", "head", "health", "heart", "heavy", "hedgehog", "height", "hello", "helmet", "help", "hen", "hero", "hidden", "high", "hill", "hint", "hip", "hire", "history", "hobby", "hockey", "hold", "hole", "holiday", "hollow", "home", "honey", "hood", "hope", "horn", "horror", "horse", "hospital", "host", "hotel", "hour", "hover", "hub", "huge", "human", "humble", "humor", "hundred", "hungry", "hunt", "hurdle", "hurry", "hurt", "husband", "hybrid", "ice", "icon", "idea", "identify", "idle", "ignore", "ill", "illegal", "illness", "image", "imitate", "immense", "immune", "impact", "impose", "improve", "impulse", "inch", "include", "income", "increase", "index", "indicate", "indoor", "industry", "infant", "inflict", "inform", "inhale", "inherit", "initial", "inject", "injury", "inmate", "inner", "innocent", "input", "inquiry", "insane", "insect", "inside", "inspire", "install", "intact", "interest", "into", "invest", "invite", "involve", "iron", "island", "isolate", "issue", "item", "ivory", "jacket", "jaguar", "jar", "jazz", "jealous", "jeans", "jelly", "jewel", "job", "join", "joke", "journey", "joy", "judge", "juice", "jump", "jungle", "junior", "junk", "just", "kangaroo", "keen", "keep", "ketchup", "key", "kick", "kid", "kidney", "kind", "kingdom", "kiss", "kit", "kitchen", "kite", "kitten", "kiwi", "knee", "knife", "knock", "know", "lab", "label", "labor", "ladder", "lady", "lake", "lamp", "language", "laptop", "large", "later", "latin", "laugh", "laundry", "lava", "law", "lawn", "lawsuit", "layer", "lazy", "leader", "leaf", "learn", "leave", "lecture", "left", "leg", "legal", "legend", "leisure", "lemon", "lend", "length", "lens", "leopard", "lesson", "letter", "level", "liar", "liberty", "library", "license", "life", "lift", "light", "like", "limb", "limit", "link", "lion", "liquid", "list", "little", "live", "lizard", "load", "loan", "lobster", "local", "lock", "logic", "lonely", "long", "loop", "lottery", "loud", "lounge", "love", "loyal", "lucky", "luggage", "lumber", "lunar", "lunch", "luxury", "lyrics", "machine", "mad", "magic", "magnet", "maid", "mail", "main", "major", "make", "mammal", "man", "manage", "mandate", "mango", "mansion", "manual", "maple", "marble", "march", "margin", "marine", "market", "marriage", "mask", "mass", "master", "match", "material", "math", "matrix", "matter", "maximum", "maze", "meadow", "mean", "measure", "meat", "mechanic", "medal", "media", "melody", "melt", "member", "memory", "mention", "menu", "mercy", "merge", "merit", "merry", "mesh", "message", "metal", "method", "middle", "midnight", "milk", "million", "mimic", "mind", "minimum", "minor", "minute", "miracle", "mirror", "misery", "miss", "mistake", "mix", "mixed", "mixture", "mobile", "model", "modify", "mom", "moment", "monitor", "monkey", "monster", "month", "moon", "moral", "more", "morning", "mosquito", "mother", "motion", "motor", "mountain", "mouse", "move", "movie", "much", "muffin", "mule", "multiply", "muscle", "museum", "mushroom", "music", "must", "mutual", "myself", "mystery", "myth", "naive", "name", "napkin", "narrow", "nasty", "nation", "nature", "near", "neck", "need", "negative", "neglect", "neither", "nephew", "nerve", "nest", "net", "network", "neutral", "never", "news", "next", "nice", "night", "noble", "noise", "nominee", "noodle", "normal", "north", "nose", "notable", "note", "nothing", "notice", "novel", "now", "nuclear", "number", "nurse", "nut", "oak", "obey", "object", "oblige", "obscure", "observe", "obtain", "obvious", "occur", "ocean", "october", "odor", "off", "offer", "office", "often", "oil", "okay", "old", "olive", "olympic", "omit", "once", "one", "onion", "online", "only", "open", "opera", "opinion", "oppose", "option", "orange", "orbit", "orchard", "order", "ordinary", "organ", "orient", "original", "orphan", "ostrich", "other", "outdoor", "outer", "output", "outside", "oval", "oven", "over", "own", "owner", "oxygen", "oyster", "ozone", "pact", "paddle", "page", "pair", "palace", "palm", "panda", "panel", "panic", "panther", "paper", "parade", "parent", "park", "parrot", "party", "pass", "patch", "path", "patient", "patrol", "pattern", "pause", "pave", "payment", "peace", "peanut", "pear", "peasant", "pelican", "pen", "penalty", "pencil", "people", "pepper", "perfect", "permit", "person", "pet", "phone", "photo", "phrase", "physical", "piano", "picnic", "picture", "piece", "pig", "pigeon", "pill", "pilot", "pink", "pioneer", "pipe", "pistol", "pitch", "pizza", "place", "planet", "plastic", "plate", "play", "please", "pledge", "pluck", "plug", "plunge", "poem", "poet", "point", "polar", "pole", "police", "pond", "pony", "pool", "popular", "portion", "position", "possible", "post", "potato", "pottery", "poverty", "powder", "power", "practice", "praise", "predict", "prefer", "prepare", "present", "pretty", "prevent", "price", "pride", "primary", "print", "priority", "prison", "private", "prize", "problem", "process", "produce", "profit", "program", "project", "promote", "proof", "property", "prosper", "protect", "proud", "provide", "public", "pudding", "pull", "pulp", "pulse", "pumpkin", "punch", "pupil", "puppy", "purchase", "purity", "purpose", "purse", "push", "put", "puzzle", "pyramid", "quality", "quantum", "quarter", "question", "quick", "quit", "quiz", "quote", "rabbit", "raccoon", "race", "rack", "radar", "radio", "rail", "rain", "raise", "rally", "ramp", "ranch", "random", "range", "rapid", "rare", "rate", "rather", "raven", "raw", "razor", "ready", "real", "reason", "rebel", "rebuild", "recall", "receive", "recipe", "record", "recycle", "reduce", "reflect", "reform", "refuse", "region", "regret", "regular", "reject", "relax", "release", "relief", "rely", "remain", "remember", "remind", "remove", "render", "renew", "rent", "reopen", "repair", "repeat", "replace", "report", "require", "rescue", "resemble", "resist", "resource", "response", "result", "retire", "retreat", "return", "reunion", "reveal", "review", "reward", "rhythm", "rib", "ribbon", "rice", "rich", "ride", "ridge", "rifle", "right", "rigid", "ring", "riot", "ripple", "risk", "ritual", "rival", "river", "road", "roast", "robot", "robust", "rocket", "romance", "roof", "rookie", "room", "rose", "rotate", "rough", "round", "route", "royal", "rubber", "rude", "rug", "rule", "run", "runway", "rural", "sad", "saddle", "sadness", "safe", "sail", "salad", "salmon", "salon", "salt", "salute", "same", "sample", "sand", "satisfy", "satoshi", "sauce", "sausage", "save", "say", "scale", "scan", "scare", "scatter", "scene", "scheme", "school", "science", "scissors", "scorpion", "scout", "scrap", "screen", "script", "scrub", "sea", "search", "season", "seat", "second", "secret", "section", "security", "seed", "seek", "segment", "select", "sell", "seminar", "senior", "sense", "sentence", "series", "service", "session", "settle", "setup", "seven", "shadow", "shaft", "shallow", "share", "shed", "shell", "sheriff", "shield", "shift", "shine", "ship", "shiver", "shock", "shoe", "shoot", "shop", "short", "shoulder", "shove", "shrimp", "shrug", "shuffle", "shy", "sibling", "sick", "side", "siege", "sight", "sign", "silent", "silk", "silly", "silver", "similar", "simple", "since", "sing", "siren", "sister", "situate", "six", "size", "skate", "sketch", "ski", "skill", "skin", "skirt", "skull", "slab", "slam", "sleep", "slender", "slice", "slide", "slight", "slim", "slogan", "slot", "slow", "slush", "small", "smart", "smile", "smoke", "smooth", "snack", "snake", "snap", "sniff", "snow", "soap", "soccer", "social", "sock", "soda", "soft", "solar", "soldier", "solid", "solution", "solve", "someone", "song", "soon", "sorry", "sort", "soul", "sound", "soup", "source", "south", "space", "spare", "spatial", "spawn", "speak", "special", "speed", "spell", "spend", "sphere", "spice", "spider", "spike", "spin", "spirit", "split", "spoil", "sponsor", "spoon", "sport", "spot", "spray", "spread", "spring", "spy", "square", "squeeze", "squirrel", "stable", "stadium", "staff", "stage", "stairs", "stamp", "stand", "start", "state", "stay", "steak", "steel", "stem", "step", "stereo", "stick", "still", "sting", "stock", "stomach", "stone", "stool", "story", "stove", "strategy", "street", "strike", "strong", "struggle", "student", "stuff", "stumble", "style", "subject", "submit", "subway", "success", "such", "sudden", "suffer", "sugar", "suggest", "suit", "summer", "sun", "sunny", "sunset", "super", "supply", "supreme", "sure", "surface", "surge", "surprise", "surround", "survey", "suspect", "sustain", "swallow", "swamp", "swap", "swarm", "swear", "sweet", "swift", "swim", "swing", "switch", "sword", "symbol", "symptom", "syrup", "system", "table", "tackle", "tag", "tail", "talent", "talk", "tank", "tape", "target", "task", "taste", "tattoo", "taxi", "teach", "team", "tell", "ten", "tenant", "tennis", "tent", "term", "test", "text", "thank", "that", "theme", "then", "theory", "there", "they", "thing", "this", "thought", "three", "thrive", "throw", "thumb", "thunder", "ticket", "tide", "tiger", "tilt", "timber", "time", "tiny", "tip", "tired", "tissue", "title", "toast", "tobacco", "today", "toddler", "toe", "together", "toilet", "token", "tomato", "tomorrow", "tone", "tongue", "tonight", "tool", "tooth", "top", "topic", "topple", "torch", "tornado", "tortoise", "toss", "total", "tourist", "toward", "tower", "town", "toy", "track", "trade", "traffic", "tragic", "train", "transfer", "trap", "trash", "travel", "tray", "treat", "tree", "trend", "trial", "tribe", "trick", "trigger", "trim", "trip", "trophy", "trouble", "truck", "true", "truly", "trumpet", "trust", "truth", "try", "tube", "tuition", "tumble", "tuna", "tunnel", "turkey", "turn", "turtle", "twelve", "twenty", "twice", "twin", "twist", "two", "type", "typical", "ugly", "umbrella", "unable", "unaware", "uncle", "uncover", "under", "undo", "unfair", "unfold", "unhappy", "uniform", "unique", "unit", "universe", "unknown", "unlock", "until", "unusual", "unveil", "update", "upgrade", "uphold", "upon", "upper", "upset", "urban", "urge", "usage", "use", "used", "useful", "useless", "usual", "utility", "vacant", "vacuum", "vague", "valid", "valley", "valve", "van", "vanish", "vapor", "various", "vast", "vault", "vehicle", "velvet", "vendor", "venture", "venue", "verb", "verify", "version", "very", "vessel", "veteran", "viable", "vibrant", "vicious", "victory", "video", "view", "village", "vintage", "violin", "virtual", "virus", "visa", "visit", "visual", "vital", "vivid", "vocal", "voice", "void", "volcano", "volume", "vote", "voyage", "wage", "wagon", "wait", "walk", "wall", "walnut", "want", "warfare", "warm", "warrior", "wash", "wasp", "waste", "water", "wave", "way", "wealth", "weapon", "wear", "weasel", "weather", "web", "wedding", "weekend", "weird", "welcome", "west", "wet", "whale", "what", "wheat", "wheel", "when", "where", "whip", "whisper", "wide", "width", "wife", "wild", "will", "win", "window", "wine", "wing", "wink", "winner", "winter", "wire", "wisdom", "wise", "wish", "witness", "wolf", "woman", "wonder", "wood", "wool", "word", "work", "world", "worry", "worth", "wrap", "wreck", "wrestle", "wrist", "write", "wrong", "yard", "year", "yellow", "you", "young", "youth", "zebra", "zero", "zone", "zoo" }
+static const char * dict[] = DICTFULL;
 
-struct waves_crypto
+char * g_seed;
+size_t g_seed_len;
+size_t g_threads;
+std::atomic<bool> g_found; // every target is found, the search stops
+std::atomic<bool> g_failed; // a block ran out of ordinals, g_found stops the search all the same
+std::atomic<size_t> g_found_count;
+std::atomic<size_t> g_hot_allocs;
+bool g_stats;
+bool g_progress;
+uint64_t g_stage_candidates; // estimate for the stage typo_search runs, for the --progress ETA
+std::atomic<uint64_t> g_input_skipped; // --input lines longer than waves_gen::max_text, never hashed
+static waves_gen::dedupe * g_dedupe_table; // for every stage that may repeat candidates
+static waves_gen::dedupe * g_dedupe; // the table, while the current stage uses it
+
+// candidates are indexed as block << 32 | ordinal: block 0 is the seed itself, then every
+// typo_run numbers its outer loop steps from g_block_base in plan order, and the ordinal
+// counts the candidates a block generates; both are independent of threads and batching;
+// typo_plan refuses a stage whose blocks could make more than max_ordinal candidates
+static const uint64_t no_index = ~(uint64_t)0;
+static const uint64_t max_ordinal = 0xffffffff;
+uint64_t g_block_base = 1;
+uint64_t g_shard;
+uint64_t g_shards = 1;
+uint64_t g_locate = no_index;
+bool g_checkpointing;
+waves_checkpoint::ranges g_checkpoint;
+std::atomic<int64_t> g_checkpoint_saved;
+
+// blocks this process may hash: everything, or the current lease of a fleet worker
+uint64_t g_range_begin;
+uint64_t g_range_end = no_index;
+bool g_quiet;
+std::atomic<uint64_t> g_probes;
+static waves_fleet::client * g_client;
+std::mutex g_cout_mutex;
+
+// heap allocations made by the current thread, typo_run sums the ones made while
+// generating and hashing candidates into g_hot_allocs; counting replaces the global
+// allocator, so only a check build made with -DWAVES_COUNT_ALLOCS does it
+static thread_local size_t g_allocs;
+
+#ifdef WAVES_COUNT_ALLOCS
+
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // every form below ends in free()
+#endif
+
+void * counted_alloc( size_t size, size_t align )
 {
-    waves_crypto() : _blake2b( 256 ), _keccak256( 256 ), _buf() {};
+    g_allocs++;
+    size = size ? size : 1;
+#ifdef _WIN32
+    void * p = _aligned_malloc( size, align );
+#else
+    void * p = nullptr;
+    if( posix_memalign( &p, align < sizeof( void * ) ? sizeof( void * ) : align, size ) )
+        p = nullptr;
+#endif
+    if( !p )
+        throw std::bad_alloc();
+    return p;
+}
+
+void counted_free( void * p ) noexcept
+{
+#ifdef _WIN32
+    _aligned_free( p );
+#else
+    free( p );
+#endif
+}
 
-    auto sechash( uint8_t * data, size_t len )
+void * operator new( size_t size ) { return counted_alloc( size, alignof( std::max_align_t ) ); }
+void * operator new[]( size_t size ) { return counted_alloc( size, alignof( std::max_align_t ) ); }
+void * operator new( size_t size, std::align_val_t align ) { return counted_alloc( size, (size_t)align ); }
+void * operator new[]( size_t size, std::align_val_t align ) { return counted_alloc( size, (size_t)align ); }
+void operator delete( void * p ) noexcept { counted_free( p ); }
+void operator delete[]( void * p ) noexcept { counted_free( p ); }
+void operator delete( void * p, size_t ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, size_t ) noexcept { counted_free( p ); }
+void operator delete( void * p, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete( void * p, size_t, std::align_val_t ) noexcept { counted_free( p ); }
+void operator delete[]( void * p, size_t, std::align_val_t ) noexcept { counted_free( p ); }
+
+#endif
+
+// one nonce-prefixed candidate buffer per worker plus its pending batch, all inline so the
+// hot path never touches the heap; the cursors of waves-gen.h mutate seed in place
+struct typo_worker
+{
+    typo_worker() : crypto( g_simd ), batch_len(), batch_index(), batch_count(), generated(), skipped(), block(), ordinal(), live()
     {
-        _blake2b.update( data, len );
-        _blake2b.final( _buf );
-        _keccak256.update( _buf, 32 );
-        _keccak256.final( _buf );
-        return _buf;
+        memset( seed, 0, sizeof( seed ) );
+        waves_address::put_nonce( seed, g_nonce );
+        reset();
     }
 
-    auto pub( uint8_t * data, size_t len )
-    {
-        static const uint8_t _base9[32] = { 9 };
+    static const size_t stride = ( 4 + waves_gen::max_text + 63 ) & ~(size_t)63;
 
-        _sha256.update( sechash( data, len ), 32 );
-        _sha256.final( _buf );
-        Botan::curve25519_donna( _buf, _buf, _base9 );
-        return _buf;
+    void reset()
+    {
+        memcpy( &seed[4], g_seed, g_seed_len );
     }
 
-    auto pubsechash( uint8_t * data, size_t len )
+    uint8_t * lane( size_t i )
     {
-        return sechash( pub( data, len ), 32 );
+        return batch[i];
     }
 
-    Botan::Blake2b _blake2b;
-    Botan::Keccak_1600 _keccak256;
-    Botan::SHA_256 _sha256;
-    uint8_t _buf[32];
+    waves_crypto crypto;
+    alignas( 64 ) uint8_t seed[stride];
+    alignas( 64 ) uint8_t batch[waves_simd::max_lanes][stride];
+    size_t batch_len[waves_simd::max_lanes];
+    uint64_t batch_index[waves_simd::max_lanes];
+    size_t batch_count;
+    uint64_t generated;
+    uint64_t skipped;
+    uint64_t block;
+    uint64_t ordinal;
+    std::atomic<uint64_t> * live; // generated, published for --progress
 };
 
-static waves_crypto g_waves_crypto;
-const char g_english[] = "abcdefghijklmnopqrstuvwxyz ";
-char * g_seed;
-size_t g_seed_len;
-
 std::vector<std::string> seed_split( std::string str )
 {
     std::istringstream split( str );
@@ -61,341 +181,1496 @@ std::vector<std::string> seed_split( std::string str )
     return words;
 }
 
-void seed_probe( uint8_t * seed, size_t len )
+size_t seed_words( const char * seed, size_t len )
+{
+    size_t n = 1;
+    for( size_t i = 0; i < len; i++ )
+        n += seed[i] == ' ';
+    return n;
+}
+
+// prints a match once per target, true for the first match of that target
+bool seed_report( const char * seed, size_t target, uint64_t index )
+{
+    if( g_hits[target].exchange( true ) )
+        return false;
+
+    std::lock_guard<std::mutex> lock( g_cout_mutex );
+    std::cout << std::endl << "FOUND SEED = \"" << seed << "\"" << std::endl;
+    std::cout << "AT INDEX = " << index << std::endl;
+    if( g_targets.size() > 1 )
+        std::cout << "FOR ADDRESS = " << g_addresses[target] << std::endl;
+    return true;
+}
+
+void seed_found( uint8_t * seed, size_t len, size_t target, uint64_t index )
+{
+    seed[len] = 0;
+    if( !seed_report( (const char *)&seed[4], target, index ) )
+        return;
+
+    if( g_client )
+        g_client->found( target, index, (const char *)&seed[4] );
+
+    if( ++g_found_count == g_targets.size() )
+        g_found = true;
+}
+
+// hashes the pending batch of w, unused lanes repeat the first candidate
+void seed_flush( typo_worker & w )
 {
-    if( 0 == memcmp( g_waves_crypto.pubsechash( seed, len ), g_pubsechash, 20 ) )
+    if( w.batch_count == 0 )
+        return;
+
+    const uint8_t * data[waves_simd::max_lanes];
+    for( size_t i = 0; i < w.crypto.lanes(); i++ )
     {
-        seed[len] = 0;
-        std::cout << std::endl << "FOUND SEED = \"" << &seed[4] << "\"" << std::endl;
-        ExitProcess( 0 );
+        size_t j = i < w.batch_count ? i : 0;
+        data[i] = w.lane( j );
+        w.batch_len[i] = w.batch_len[j];
     }
+
+    auto hashes = w.crypto.pubsechash_xN( data, w.batch_len, w.batch_count );
+    for( size_t i = 0; i < w.batch_count; i++ )
+    {
+        size_t target = g_targets.find( hashes[i] );
+        if( target != waves_targets::npos )
+            seed_found( w.lane( i ), w.batch_len[i], target, w.batch_index[i] );
+    }
+
+    w.batch_count = 0;
 }
 
-void set_pubsechash( char * address )
+void seed_probe( typo_worker & w, uint8_t * seed, size_t len )
 {
-    uint8_t * buf = g_pubsechash;
-    size_t len = sizeof( g_pubsechash );
-    d58( address, strlen( address ), &buf, &len );
+    if( g_found.load( std::memory_order_relaxed ) )
+        return;
 
-    if( buf[0] != 1 ||
-        buf[1] != 'W' ||
-        memcmp( &buf[22], g_waves_crypto.sechash( buf, 22 ), 4 ) )
+    // the other workers unwind, the blocks completed so far stay in the checkpoint
+    if( w.ordinal > max_ordinal )
     {
-        std::cout << "Bad MAINNET address: " << address << std::endl;
-        ExitProcess( 1 );
+        if( !g_failed.exchange( true ) )
+        {
+            std::lock_guard<std::mutex> lock( g_cout_mutex );
+            std::cout << std::endl << "ERROR: block " << w.block << " makes more than 2^32 candidates" << std::endl;
+        }
+        g_found = true;
+        return;
+    }
+    uint64_t index = w.block << 32 | w.ordinal++;
+    if( g_locate != no_index )
+    {
+        if( index == g_locate )
+        {
+            seed[len] = 0;
+            std::cout << "CANDIDATE " << index << " = \"" << &seed[4] << "\"" << std::endl;
+        }
+        return;
+    }
+
+    if( ( ++w.generated & 255 ) == 0 && w.live )
+        w.live->store( w.generated, std::memory_order_relaxed );
+    if( g_dedupe && g_dedupe->seen( waves_gen::fingerprint( seed + 4, len - 4 ) ) )
+    {
+        w.skipped++;
+        return;
     }
 
-    memmove( g_pubsechash, &buf[2], 20 );
+    if( w.crypto.lanes() == 1 )
+    {
+        size_t target = g_targets.find( w.crypto.pubsechash( seed, len ) );
+        if( target != waves_targets::npos )
+            seed_found( seed, len, target, index );
+        return;
+    }
+
+    if( w.batch_count && waves_simd::blake2b_blocks( w.batch_len[0] ) != waves_simd::blake2b_blocks( len ) )
+        seed_flush( w );
+
+    if( seed != w.lane( w.batch_count ) )
+        memcpy( w.lane( w.batch_count ), seed, len );
+    w.batch_len[w.batch_count] = len;
+    w.batch_index[w.batch_count] = index;
+    if( ++w.batch_count == w.crypto.lanes() )
+        seed_flush( w );
 }
 
-int main( int argc, char ** argv )
+// a candidate from outside: text is copied once, behind the prefix of the buffer it is hashed from
+void seed_probe_text( typo_worker & w, const char * text, size_t len )
 {
-    std::cout << "waves-typo (" << __DATE__ << ")" << std::endl;
-    if( argc < 3 )
+    if( len == 0 || len > waves_gen::max_text )
     {
-        std::cout << "Usage: waves-typo.exe \"address\" \"seed\"" << std::endl;
-        Sleep( 5000 );
-        return 1;
+        if( len && g_input_skipped++ == 0 && g_locate == no_index )
+        {
+            std::lock_guard<std::mutex> lock( g_cout_mutex );
+            std::cout << std::endl << "WARNING: line at index " << ( w.block << 32 | w.ordinal ) << " is longer than "
+                << waves_gen::max_text << " bytes, it and every other such line are skipped" << std::endl;
+        }
+        w.ordinal++;
+        return;
     }
 
-    set_pubsechash( argv[1] );
-    g_seed = argv[2];
-    g_seed_len = strlen( g_seed );
+    if( w.crypto.lanes() > 1 && w.batch_count && waves_simd::blake2b_blocks( w.batch_len[0] ) != waves_simd::blake2b_blocks( 4 + len ) )
+        seed_flush( w );
 
-    uint8_t * seed = new uint8_t[g_seed_len + 4 + 2 + 32]();
-    memcpy( &seed[4], g_seed, g_seed_len );
-    seed_probe( seed, 4 + g_seed_len );
+    uint8_t * seed = w.crypto.lanes() == 1 ? w.seed : w.lane( w.batch_count );
+    if( seed != w.seed )
+        memcpy( seed, w.seed, 4 );
+    memcpy( seed + 4, text, len );
+    seed_probe( w, seed, 4 + len );
+}
 
-#if 1
+// records blocks [begin, end) as completed, saving the checkpoint at most once a minute
+void typo_completed( uint64_t begin, uint64_t end )
+{
+    if( !g_checkpointing )
+        return;
+
+    g_checkpoint.complete( begin, end );
+    int64_t now = std::chrono::duration_cast<std::chrono::seconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+    int64_t saved = g_checkpoint_saved;
+    if( now - saved >= 60 && g_checkpoint_saved.compare_exchange_strong( saved, now ) )
+        g_checkpoint.save();
+}
 
-#define DICTFULL { "abandon", "ability", "able", "about", "above", "absent", "absorb", "abstract", "absurd", "abuse", "access", "accident", "account", "accuse", "achieve", "acid", "acoustic", "acquire", "across", "act", "action", "actor", "actress", "actual", "adapt", "add", "addict", "address", "adjust", "admit", "adult", "advance", "advice", "aerobic", "affair", "afford", "afraid", "again", "age", "agent", "agree", "ahead", "aim", "air", "airport", "aisle", "alarm", "album", "alcohol", "alert", "alien", "all", "alley", "allow", "almost", "alone", "alpha", "already", "also", "alter", "always", "amateur", "amazing", "among", "amount", "amused", "analyst", "anchor", "ancient", "anger", "angle", "angry", "animal", "ankle", "announce", "annual", "another", "answer", "antenna", "antique", "anxiety", "any", "apart", "apology", "appear", "apple", "approve", "april", "arch", "arctic", "area", "arena", "argue", "arm", "armed", "armor", "army", "around", "arrange", "arrest", "arrive", "arrow", "art", "artefact", "artist", "artwork", "ask", "aspect", "assault", "asset", "assist", "assume", "asthma", "athlete", "atom", "attack", "attend", "attitude", "attract", "auction", "audit", "august", "aunt", "author", "auto", "autumn", "average", "avocado", "avoid", "awake", "aware", "away", "awesome", "awful", "awkward", "axis", "baby", "bachelor", "bacon", "badge", "bag", "balance", "balcony", "ball", "bamboo", "banana", "banner", "bar", "barely", "bargain", "barrel", "base", "basic", "basket", "battle", "beach", "bean", "beauty", "because", "become", "beef", "before", "begin", "behave", "behind", "believe", "below", "belt", "bench", "benefit", "best", "betray", "better", "between", "beyond", "bicycle", "bid", "bike", "bind", "biology", "bird", "birth", "bitter", "black", "blade", "blame", "blanket", "blast", "bleak", "bless", "blind", "blood", "blossom", "blouse", "blue", "blur", "blush", "board", "boat", "body", "boil", "bomb", "bone", "bonus", "book", "boost", "border", "boring", "borrow", "boss", "bottom", "bounce", "box", "boy", "bracket", "brain", "brand", "brass", "brave", "bread", "breeze", "brick", "bridge", "brief", "bright", "bring", "brisk", "broccoli", "broken", "bronze", "broom", "brother", "brown", "brush", "bubble", "buddy", "budget", "buffalo", "build", "bulb", "bulk", "bullet", "bundle", "bunker", "burden", "burger", "burst", "bus", "business", "busy", "butter", "buyer", "buzz", "cabbage", "cabin", "cable", "cactus", "cage", "cake", "call", "calm", "camera", "camp", "can", "canal", "cancel", "candy", "cannon", "canoe", "canvas", "canyon", "capable", "capital", "captain", "car", "carbon", "card", "cargo", "carpet", "carry", "cart", "case", "cash", "casino", "castle", "casual", "cat", "catalog", "catch", "category", "cattle", "caught", "cause", "caution", "cave", "ceiling", "celery", "cement", "census", "century", "cereal", "certain", "chair", "chalk", "champion", "change", "chaos", "chapter", "charge", "chase", "chat", "cheap", "check", "cheese", "chef", "cherry", "chest", "chicken", "chief", "child", "chimney", "choice", "choose", "chronic", "chuckle", "chunk", "churn", "cigar", "cinnamon", "circle", "citizen", "city", "civil", "claim", "clap", "clarify", "claw", "clay", "clean", "clerk", "clever", "click", "client", "cliff", "climb", "clinic", "clip", "clock", "clog", "close", "cloth", "cloud", "clown", "club", "clump", "cluster", "clutch", "coach", "coast", "coconut", "code", "coffee", "coil", "coin", "collect", "color", "column", "combine", "come", "comfort", "comic", "common", "company", "concert", "conduct", "confirm", "congress", "connect", "consider", "control", "convince", "cook", "cool", "copper", "copy", "coral", "core", "corn", "correct", "cost", "cotton", "couch", "country", "couple", "course", "cousin", "cover", "coyote", "crack", "cradle", "craft", "cram", "crane", "crash", "crater", "crawl", "crazy", "cream", "credit", "creek", "crew", "cricket", "crime", "crisp", "critic", "crop", "cross", "crouch", "crowd", "crucial", "cruel", "cruise", "crumble", "crunch", "crush", "cry", "crystal", "cube", "culture", "cup", "cupboard", "curious", "current", "curtain", "curve", "cushion", "custom", "cute", "cycle", "dad", "damage", "damp", "dance", "danger", "daring", "dash", "daughter", "dawn", "day", "deal", "debate", "debris", "decade", "december", "decide", "decline", "decorate", "decrease", "deer", "defense", "define", "defy", "degree", "delay", "deliver", "demand", "demise", "denial", "dentist", "deny", "depart", "depend", "deposit", "depth", "deputy", "derive", "describe", "desert", "design", "desk", "despair", "destroy", "detail", "detect", "develop", "device", "devote", "diagram", "dial", "diamond", "diary", "dice", "diesel", "diet", "differ", "digital", "dignity", "dilemma", "dinner", "dinosaur", "direct", "dirt", "disagree", "discover", "disease", "dish", "dismiss", "disorder", "display", "distance", "divert", "divide", "divorce", "dizzy", "doctor", "document", "dog", "doll", "dolphin", "domain", "donate", "donkey", "donor", "door", "dose", "double", "dove", "draft", "dragon", "drama", "drastic", "draw", "dream", "dress", "drift", "drill", "drink", "drip", "drive", "drop", "drum", "dry", "duck", "dumb", "dune", "during", "dust", "dutch", "duty", "dwarf", "dynamic", "eager", "eagle", "early", "earn", "earth", "easily", "east", "easy", "echo", "ecology", "economy", "edge", "edit", "educate", "effort", "egg", "eight", "either", "elbow", "elder", "electric", "elegant", "element", "elephant", "elevator", "elite", "else", "embark", "embody", "embrace", "emerge", "emotion", "employ", "empower", "empty", "enable", "enact", "end", "endless", "endorse", "enemy", "energy", "enforce", "engage", "engine", "enhance", "enjoy", "enlist", "enough", "enrich", "enroll", "ensure", "enter", "entire", "entry", "envelope", "episode", "equal", "equip", "era", "erase", "erode", "erosion", "error", "erupt", "escape", "essay", "essence", "estate", "eternal", "ethics", "evidence", "evil", "evoke", "evolve", "exact", "example", "excess", "exchange", "excite", "exclude", "excuse", "execute", "exercise", "exhaust", "exhibit", "exile", "exist", "exit", "exotic", "expand", "expect", "expire", "explain", "expose", "express", "extend", "extra", "eye", "eyebrow", "fabric", "face", "faculty", "fade", "faint", "faith", "fall", "false", "fame", "family", "famous", "fan", "fancy", "fantasy", "farm", "fashion", "fat", "fatal", "father", "fatigue", "fault", "favorite", "feature", "february", "federal", "fee", "feed", "feel", "female", "fence", "festival", "fetch", "fever", "few", "fiber", "fiction", "field", "figure", "file", "film", "filter", "final", "find", "fine", "finger", "finish", "fire", "firm", "first", "fiscal", "fish", "fit", "fitness", "fix", "flag", "flame", "flash", "flat", "flavor", "flee", "flight", "flip", "float", "flock", "floor", "flower", "fluid", "flush", "fly", "foam", "focus", "fog", "foil", "fold", "follow", "food", "foot", "force", "forest", "forget", "fork", "fortune", "forum", "forward", "fossil", "foster", "found", "fox", "fragile", "frame", "frequent", "fresh", "friend", "fringe", "frog", "front", "frost", "frown", "frozen", "fruit", "fuel", "fun", "funny", "furnace", "fury", "future", "gadget", "gain", "galaxy", "gallery", "game", "gap", "garage", "garbage", "garden", "garlic", "garment", "gas", "gasp", "gate", "gather", "gauge", "gaze", "general", "genius", "genre", "gentle", "genuine", "gesture", "ghost", "giant", "gift", "giggle", "ginger", "giraffe", "girl", "give", "glad", "glance", "glare", "glass", "glide", "glimpse", "globe", "gloom", "glory", "glove", "glow", "glue", "goat", "goddess", "gold", "good", "goose", "gorilla", "gospel", "gossip", "govern", "gown", "grab", "grace", "grain", "grant", "grape", "grass", "gravity", "great", "green", "grid", "grief", "grit", "grocery", "group", "grow", "grunt", "guard", "guess", "guide", "guilt", "guitar", "gun", "gym", "habit", "hair", "half", "hammer", "hamster", "hand", "happy", "harbor", "hard", "harsh", "harvest", "hat", "have", "hawk", "hazard", "head", "health", "heart", "heavy", "hedgehog", "height", "hello", "helmet", "help", "hen", "hero", "hidden", "high", "hill", "hint", "hip", "hire", "history", "hobby", "hockey", "hold", "hole", "holiday", "hollow", "home", "honey", "hood", "hope", "horn", "horror", "horse", "hospital", "host", "hotel", "hour", "hover", "hub", "huge", "human", "humble", "humor", "hundred", "hungry", "hunt", "hurdle", "hurry", "hurt", "husband", "hybrid", "ice", "icon", "idea", "identify", "idle", "ignore", "ill", "illegal", "illness", "image", "imitate", "immense", "immune", "impact", "impose", "improve", "impulse", "inch", "include", "income", "increase", "index", "indicate", "indoor", "industry", "infant", "inflict", "inform", "inhale", "inherit", "initial", "inject", "injury", "inmate", "inner", "innocent", "input", "inquiry", "insane", "insect", "inside", "inspire", "install", "intact", "interest", "into", "invest", "invite", "involve", "iron", "island", "isolate", "issue", "item", "ivory", "jacket", "jaguar", "jar", "jazz", "jealous", "jeans", "jelly", "jewel", "job", "join", "joke", "journey", "joy", "judge", "juice", "jump", "jungle", "junior", "junk", "just", "kangaroo", "keen", "keep", "ketchup", "key", "kick", "kid", "kidney", "kind", "kingdom", "kiss", "kit", "kitchen", "kite", "kitten", "kiwi", "knee", "knife", "knock", "know", "lab", "label", "labor", "ladder", "lady", "lake", "lamp", "language", "laptop", "large", "later", "latin", "laugh", "laundry", "lava", "law", "lawn", "lawsuit", "layer", "lazy", "leader", "leaf", "learn", "leave", "lecture", "left", "leg", "legal", "legend", "leisure", "lemon", "lend", "length", "lens", "leopard", "lesson", "letter", "level", "liar", "liberty", "library", "license", "life", "lift", "light", "like", "limb", "limit", "link", "lion", "liquid", "list", "little", "live", "lizard", "load", "loan", "lobster", "local", "lock", "logic", "lonely", "long", "loop", "lottery", "loud", "lounge", "love", "loyal", "lucky", "luggage", "lumber", "lunar", "lunch", "luxury", "lyrics", "machine", "mad", "magic", "magnet", "maid", "mail", "main", "major", "make", "mammal", "man", "manage", "mandate", "mango", "mansion", "manual", "maple", "marble", "march", "margin", "marine", "market", "marriage", "mask", "mass", "master", "match", "material", "math", "matrix", "matter", "maximum", "maze", "meadow", "mean", "measure", "meat", "mechanic", "medal", "media", "melody", "melt", "member", "memory", "mention", "menu", "mercy", "merge", "merit", "merry", "mesh", "message", "metal", "method", "middle", "midnight", "milk", "million", "mimic", "mind", "minimum", "minor", "minute", "miracle", "mirror", "misery", "miss", "mistake", "mix", "mixed", "mixture", "mobile", "model", "modify", "mom", "moment", "monitor", "monkey", "monster", "month", "moon", "moral", "more", "morning", "mosquito", "mother", "motion", "motor", "mountain", "mouse", "move", "movie", "much", "muffin", "mule", "multiply", "muscle", "museum", "mushroom", "music", "must", "mutual", "myself", "mystery", "myth", "naive", "name", "napkin", "narrow", "nasty", "nation", "nature", "near", "neck", "need", "negative", "neglect", "neither", "nephew", "nerve", "nest", "net", "network", "neutral", "never", "news", "next", "nice", "night", "noble", "noise", "nominee", "noodle", "normal", "north", "nose", "notable", "note", "nothing", "notice", "novel", "now", "nuclear", "number", "nurse", "nut", "oak", "obey", "object", "oblige", "obscure", "observe", "obtain", "obvious", "occur", "ocean", "october", "odor", "off", "offer", "office", "often", "oil", "okay", "old", "olive", "olympic", "omit", "once", "one", "onion", "online", "only", "open", "opera", "opinion", "oppose", "option", "orange", "orbit", "orchard", "order", "ordinary", "organ", "orient", "original", "orphan", "ostrich", "other", "outdoor", "outer", "output", "outside", "oval", "oven", "over", "own", "owner", "oxygen", "oyster", "ozone", "pact", "paddle", "page", "pair", "palace", "palm", "panda", "panel", "panic", "panther", "paper", "parade", "parent", "park", "parrot", "party", "pass", "patch", "path", "patient", "patrol", "pattern", "pause", "pave", "payment", "peace", "peanut", "pear", "peasant", "pelican", "pen", "penalty", "pencil", "people", "pepper", "perfect", "permit", "person", "pet", "phone", "photo", "phrase", "physical", "piano", "picnic", "picture", "piece", "pig", "pigeon", "pill", "pilot", "pink", "pioneer", "pipe", "pistol", "pitch", "pizza", "place", "planet", "plastic", "plate", "play", "please", "pledge", "pluck", "plug", "plunge", "poem", "poet", "point", "polar", "pole", "police", "pond", "pony", "pool", "popular", "portion", "position", "possible", "post", "potato", "pottery", "poverty", "powder", "power", "practice", "praise", "predict", "prefer", "prepare", "present", "pretty", "prevent", "price", "pride", "primary", "print", "priority", "prison", "private", "prize", "problem", "process", "produce", "profit", "program", "project", "promote", "proof", "property", "prosper", "protect", "proud", "provide", "public", "pudding", "pull", "pulp", "pulse", "pumpkin", "punch", "pupil", "puppy", "purchase", "purity", "purpose", "purse", "push", "put", "puzzle", "pyramid", "quality", "quantum", "quarter", "question", "quick", "quit", "quiz", "quote", "rabbit", "raccoon", "race", "rack", "radar", "radio", "rail", "rain", "raise", "rally", "ramp", "ranch", "random", "range", "rapid", "rare", "rate", "rather", "raven", "raw", "razor", "ready", "real", "reason", "rebel", "rebuild", "recall", "receive", "recipe", "record", "recycle", "reduce", "reflect", "reform", "refuse", "region", "regret", "regular", "reject", "relax", "release", "relief", "rely", "remain", "remember", "remind", "remove", "render", "renew", "rent", "reopen", "repair", "repeat", "replace", "report", "require", "rescue", "resemble", "resist", "resource", "response", "result", "retire", "retreat", "return", "reunion", "reveal", "review", "reward", "rhythm", "rib", "ribbon", "rice", "rich", "ride", "ridge", "rifle", "right", "rigid", "ring", "riot", "ripple", "risk", "ritual", "rival", "river", "road", "roast", "robot", "robust", "rocket", "romance", "roof", "rookie", "room", "rose", "rotate", "rough", "round", "route", "royal", "rubber", "rude", "rug", "rule", "run", "runway", "rural", "sad", "saddle", "sadness", "safe", "sail", "salad", "salmon", "salon", "salt", "salute", "same", "sample", "sand", "satisfy", "satoshi", "sauce", "sausage", "save", "say", "scale", "scan", "scare", "scatter", "scene", "scheme", "school", "science", "scissors", "scorpion", "scout", "scrap", "screen", "script", "scrub", "sea", "search", "season", "seat", "second", "secret", "section", "security", "seed", "seek", "segment", "select", "sell", "seminar", "senior", "sense", "sentence", "series", "service", "session", "settle", "setup", "seven", "shadow", "shaft", "shallow", "share", "shed", "shell", "sheriff", "shield", "shift", "shine", "ship", "shiver", "shock", "shoe", "shoot", "shop", "short", "shoulder", "shove", "shrimp", "shrug", "shuffle", "shy", "sibling", "sick", "side", "siege", "sight", "sign", "silent", "silk", "silly", "silver", "similar", "simple", "since", "sing", "siren", "sister", "situate", "six", "size", "skate", "sketch", "ski", "skill", "skin", "skirt", "skull", "slab", "slam", "sleep", "slender", "slice", "slide", "slight", "slim", "slogan", "slot", "slow", "slush", "small", "smart", "smile", "smoke", "smooth", "snack", "snake", "snap", "sniff", "snow", "soap", "soccer", "social", "sock", "soda", "soft", "solar", "soldier", "solid", "solution", "solve", "someone", "song", "soon", "sorry", "sort", "soul", "sound", "soup", "source", "south", "space", "spare", "spatial", "spawn", "speak", "special", "speed", "spell", "spend", "sphere", "spice", "spider", "spike", "spin", "spirit", "split", "spoil", "sponsor", "spoon", "sport", "spot", "spray", "spread", "spring", "spy", "square", "squeeze", "squirrel", "stable", "stadium", "staff", "stage", "stairs", "stamp", "stand", "start", "state", "stay", "steak", "steel", "stem", "step", "stereo", "stick", "still", "sting", "stock", "stomach", "stone", "stool", "story", "stove", "strategy", "street", "strike", "strong", "struggle", "student", "stuff", "stumble", "style", "subject", "submit", "subway", "success", "such", "sudden", "suffer", "sugar", "suggest", "suit", "summer", "sun", "sunny", "sunset", "super", "supply", "supreme", "sure", "surface", "surge", "surprise", "surround", "survey", "suspect", "sustain", "swallow", "swamp", "swap", "swarm", "swear", "sweet", "swift", "swim", "swing", "switch", "sword", "symbol", "symptom", "syrup", "system", "table", "tackle", "tag", "tail", "talent", "talk", "tank", "tape", "target", "task", "taste", "tattoo", "taxi", "teach", "team", "tell", "ten", "tenant", "tennis", "tent", "term", "test", "text", "thank", "that", "theme", "then", "theory", "there", "they", "thing", "this", "thought", "three", "thrive", "throw", "thumb", "thunder", "ticket", "tide", "tiger", "tilt", "timber", "time", "tiny", "tip", "tired", "tissue", "title", "toast", "tobacco", "today", "toddler", "toe", "together", "toilet", "token", "tomato", "tomorrow", "tone", "tongue", "tonight", "tool", "tooth", "top", "topic", "topple", "torch", "tornado", "tortoise", "toss", "total", "tourist", "toward", "tower", "town", "toy", "track", "trade", "traffic", "tragic", "train", "transfer", "trap", "trash", "travel", "tray", "treat", "tree", "trend", "trial", "tribe", "trick", "trigger", "trim", "trip", "trophy", "trouble", "truck", "true", "truly", "trumpet", "trust", "truth", "try", "tube", "tuition", "tumble", "tuna", "tunnel", "turkey", "turn", "turtle", "twelve", "twenty", "twice", "twin", "twist", "two", "type", "typical", "ugly", "umbrella", "unable", "unaware", "uncle", "uncover", "under", "undo", "unfair", "unfold", "unhappy", "uniform", "unique", "unit", "universe", "unknown", "unlock", "until", "unusual", "unveil", "update", "upgrade", "uphold", "upon", "upper", "upset", "urban", "urge", "usage", "use", "used", "useful", "useless", "usual", "utility", "vacant", "vacuum", "vague", "valid", "valley", "valve", "van", "vanish", "vapor", "various", "vast", "vault", "vehicle", "velvet", "vendor", "venture", "venue", "verb", "verify", "version", "very", "vessel", "veteran", "viable", "vibrant", "vicious", "victory", "video", "view", "village", "vintage", "violin", "virtual", "virus", "visa", "visit", "visual", "vital", "vivid", "vocal", "voice", "void", "volcano", "volume", "vote", "voyage", "wage", "wagon", "wait", "walk", "wall", "walnut", "want", "warfare", "warm", "warrior", "wash", "wasp", "waste", "water", "wave", "way", "wealth", "weapon", "wear", "weasel", "weather", "web", "wedding", "weekend", "weird", "welcome", "west", "wet", "whale", "what", "wheat", "wheel", "when", "where", "whip", "whisper", "wide", "width", "wife", "wild", "will", "win", "window", "wine", "wing", "wink", "winner", "winter", "wire", "wisdom", "wise", "wish", "witness", "wolf", "woman", "wonder", "wood", "wool", "word", "work", "world", "worry", "worth", "wrap", "wreck", "wrestle", "wrist", "write", "wrong", "yard", "year", "yellow", "you", "young", "youth", "zebra", "zero", "zone", "zoo" }
-    static const char * dict[] = DICTFULL;
-
-#if 1
-
-    // 1 WORD MISS
-    std::cout << "1 WORD MISS... ";
-    auto words = seed_split( g_seed );
-    size_t n = words.size();
-    for( size_t i = 0; i <= n; i++ )
-    {
-        std::string part0( "\0\0\0\0", 4 );
-        std::string part1;
-        std::string part2;
-        std::string part3;
-        for( size_t w = 0; w < i; w++ )
-            part1 += ( w != 0 ? " " : "" ) + words[w];
-        for( size_t w = i; w < n; w++ )
-            part3 += " " + words[w];
-
-        for( size_t j = 0; j < 2048; j++ )
-        {
-            part2 = ( i != 0 ? " " : "" ) + std::string( dict[j] );
-            std::string tester = part0 + part1 + part2 + part3;
-            seed_probe( (uint8_t *)tester.c_str(), tester.size() );
+// this instance hashes block when it is in its range and shard and no earlier run completed it
+bool typo_wanted( uint64_t block )
+{
+    return block >= g_range_begin && block < g_range_end && block % g_shards == g_shard && !g_checkpoint.loaded( block );
+}
+
+std::string typo_duration( double seconds )
+{
+    uint64_t s = (uint64_t)seconds;
+    char text[32];
+    snprintf( text, sizeof( text ), "%llu:%02u:%02u", (unsigned long long)( s / 3600 ), (unsigned)( s / 60 % 60 ), (unsigned)( s % 60 ) );
+    return text;
+}
+
+// every 2 seconds prints candidates/sec of the stage and of each thread, with the share of
+// expected candidates done and an ETA; live holds the candidates each thread generated so far
+void typo_progress( const char * name, const std::atomic<uint64_t> * live, const std::atomic<bool> & finished, bool & reported, double expected )
+{
+    typedef std::chrono::steady_clock clock;
+    auto start = clock::now();
+    auto last = start;
+    std::vector<uint64_t> before( g_threads );
+    for( ;; )
+    {
+        for( int i = 0; i < 20 && !finished; i++ )
+            std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        if( finished || g_found )
+            return;
+
+        auto now = clock::now();
+        double elapsed = std::chrono::duration<double>( now - last ).count();
+        double total = std::chrono::duration<double>( now - start ).count();
+        last = now;
+
+        std::ostringstream threads;
+        uint64_t done = 0, delta = 0;
+        for( size_t t = 0; t < g_threads; t++ )
+        {
+            uint64_t n = live[t].load( std::memory_order_relaxed );
+            threads << " " << (uint64_t)( ( n - before[t] ) / elapsed );
+            delta += n - before[t];
+            done += n;
+            before[t] = n;
         }
+
+        double rate = delta / elapsed;
+        double average = done / total;
+        double left = expected > done ? expected - done : 0;
+        std::lock_guard<std::mutex> lock( g_cout_mutex );
+        reported = true;
+        std::cout << std::endl << "    " << name << ": " << done << " of ~" << (uint64_t)expected
+            << " (" << std::fixed << std::setprecision( 1 ) << ( expected ? 100 * std::min( 1.0, done / expected ) : 100 ) << "%), "
+            << (uint64_t)rate << " cand/s, ETA " << ( average > 0 ? typo_duration( left / average ) : "?" )
+            << ", per thread:" << threads.str();
+        if( uint64_t skipped = g_input_skipped )
+            std::cout << ", " << skipped << " lines too long";
+        std::cout << std::flush;
     }
-    std::cout << "NO" << std::endl;
+}
 
-#else
+// runs f( worker, i ) for every i in [0, count) on g_threads workers,
+// handing out the outer loop indexes in chunks from a shared cursor;
+// f must leave worker.seed as it found it, which the waves-gen cursors do
+template <typename F>
+void typo_run( const char * name, size_t count, bool countdown, F f )
+{
+    uint64_t base = g_block_base;
+    g_block_base += count;
+
+    if( g_locate != no_index )
+    {
+        uint64_t block = g_locate >> 32;
+        if( block >= base && block < base + count )
+        {
+            typo_worker w;
+            w.block = block;
+            f( w, block - base );
+        }
+        return;
+    }
 
-    // 1 LAST WORD ADD
-    std::cout << "1 LAST WORD ADD... ";
-    seed[4 + g_seed_len] = ' ';
-    for( size_t i = 0; i < 2048; i++ )
+    // the outer loop steps inside [g_range_begin, g_range_end)
+    size_t lo = g_range_begin > base ? (size_t)std::min<uint64_t>( g_range_begin - base, count ) : 0;
+    size_t hi = g_range_end < base + count ? (size_t)( g_range_end > base ? g_range_end - base : 0 ) : count;
+    if( g_found || lo >= hi )
+        return;
+
+    // --progress reports replace the countdown
+    bool progress = g_progress && !g_quiet;
+    if( progress )
+        countdown = false;
+
+    if( !g_quiet )
     {
-        memcpy( &seed[4 + g_seed_len + 1], dict[i], strlen( dict[i] ) );
-        seed_probe( seed, 4 + g_seed_len + 1 + strlen( dict[i] ) );
+        std::cout << name << "... ";
+        if( countdown )
+            std::cout << hi - lo << "... ";
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
 
-    // 2 LAST WORDS ADD
-    std::cout << "2 LAST WORDS ADD... ";
-    seed[4 + g_seed_len] = ' ';
-    for( size_t i = 0; i < 2048; i++ )
+    size_t chunk = ( hi - lo ) / ( g_threads * 16 );
+    if( chunk == 0 )
+        chunk = 1;
+
+    std::atomic<size_t> next( lo );
+    std::atomic<size_t> done( 0 );
+    std::atomic<uint64_t> generated( 0 );
+    std::atomic<uint64_t> skipped( 0 );
+    std::unique_ptr<std::atomic<uint64_t>[]> live( new std::atomic<uint64_t>[g_threads]() );
+    auto work = [&]( size_t t )
     {
-        memcpy( &seed[4 + g_seed_len + 1], dict[i], strlen( dict[i] ) );
-        seed[4 + g_seed_len + 1 + strlen( dict[i] )] = ' ';
-        for( size_t j = 0; j < 2048; j++ )
+        typo_worker w;
+        w.live = &live[t];
+        size_t allocs = 0;
+        uint64_t probes = 0;
+        for( ;; )
         {
-            if( i == j )
-                continue;
+            size_t i = next.fetch_add( chunk );
+            if( i >= hi || g_found )
+                break;
 
-            memcpy( &seed[4 + g_seed_len + 1 + strlen( dict[i] ) + 1], dict[j], strlen( dict[j] ) );
-            seed_probe( seed, 4 + g_seed_len + 1 + strlen( dict[i] ) + 1 + strlen( dict[j] ) );
+            size_t first = i;
+            size_t end = i + chunk < hi ? i + chunk : hi;
+            for( ; i < end && !g_found; i++ )
+            {
+                if( typo_wanted( base + i ) )
+                {
+                    size_t before = g_allocs;
+                    w.block = base + i;
+                    w.ordinal = 0;
+                    f( w, i );
+                    allocs += g_allocs - before;
+                }
+
+                size_t left = hi - lo - ++done;
+                if( countdown && !g_found && !g_quiet )
+                {
+                    std::lock_guard<std::mutex> lock( g_cout_mutex );
+                    std::cout << left << "... ";
+                }
+            }
+
+            // the chunk counts as completed only once its candidates are hashed
+            size_t before = g_allocs;
+            seed_flush( w );
+            allocs += g_allocs - before;
+            g_probes += w.generated - w.skipped - probes;
+            probes = w.generated - w.skipped;
+            if( !g_found )
+                typo_completed( base + first, base + end );
         }
+        size_t before = g_allocs;
+        seed_flush( w );
+        g_hot_allocs += allocs + g_allocs - before;
+        generated += w.generated;
+        skipped += w.skipped;
+    };
+
+    std::atomic<bool> finished( false );
+    bool reported = false;
+    std::thread reporter;
+    if( progress )
+        reporter = std::thread( typo_progress, name, live.get(), std::ref( finished ), std::ref( reported ),
+            (double)g_stage_candidates * ( hi - lo ) / count / g_shards );
+
+    std::vector<std::thread> threads;
+    for( size_t t = 1; t < g_threads; t++ )
+        threads.emplace_back( work, t );
+    work( 0 );
+    for( auto & t : threads )
+        t.join();
+
+    finished = true;
+    if( reporter.joinable() )
+        reporter.join();
+
+    if( !g_found && !g_quiet )
+        std::cout << ( reported ? "\n" + std::string( name ) + "... " : "" ) << "NO" << std::endl;
+    if( g_checkpointing )
+        g_checkpoint.save();
+    if( g_stats && !g_quiet )
+        std::cout << "    generated " << generated << ", skipped " << skipped << ", hashed " << generated - skipped << std::endl;
+}
 
-        std::cout << 2048 - i << "... ";
-    }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
+// dict by word length, so neighbours differ only in their letters
+std::vector<waves_gen::word_ref> g_dict;
+// the seed words themselves, for word-dup
+std::vector<waves_gen::word_ref> g_words;
+// single letter edits of the seed by likelihood, for likely
+waves_likely::model g_likely;
 
-#endif
+// per seed word, the dict words within word_fix_max edits of it, closest first, for word-fix
+struct word_option
+{
+    waves_gen::word_ref word;
+    size_t distance;
+};
+static const size_t word_fix_max = 4;
+std::vector<std::vector<word_option>> g_options;
 
-#else
+void typo_word_miss( const char * title, size_t )
+{
+    size_t n = g_words.size();
+    typo_run( title, n + 1, false, [&]( typo_worker & w, size_t i )
+    {
+        uint8_t * text = &w.seed[4];
+        size_t at = i < n ? waves_gen::word_start( text, g_seed_len, i ) : g_seed_len;
+        waves_gen::word_insert add( text, g_seed_len, at, i == n, &g_dict[0], 0, g_dict.size() );
+        while( add.next() )
+            seed_probe( w, w.seed, 4 + add.len() );
+    } );
+}
+
+void typo_word_add_last( const char * title, size_t k )
+{
+    typo_run( title, g_dict.size(), k == 2, [&]( typo_worker & w, size_t i )
+    {
+        waves_gen::word_insert add( &w.seed[4], g_seed_len, g_seed_len, true, &g_dict[0], i, i + 1 );
+        while( add.next() )
+        {
+            if( k == 1 )
+            {
+                seed_probe( w, w.seed, 4 + add.len() );
+                continue;
+            }
 
-    auto words = seed_split( g_seed );
+            waves_gen::word_insert add2( &w.seed[4], add.len(), add.len(), true, &g_dict[0], 0, g_dict.size() );
+            while( add2.next() )
+                if( add2.index() != i )
+                    seed_probe( w, w.seed, 4 + add2.len() );
+        }
+    } );
+}
 
-    // 1 WORD MISS
-    std::cout << "1 WORD MISS... ";
-    for( size_t i = 0; i < words.size(); i++ )
+void typo_word_drop( const char * title, size_t k )
+{
+    size_t n = g_words.size();
+    typo_run( title, n, false, [&]( typo_worker & w, size_t i )
     {
-        size_t s = 0;
-        for( size_t j = 0; j < words.size(); j++ )
+        waves_gen::word_delete del( &w.seed[4], g_seed_len, i, i + 1 );
+        while( del.next() )
         {
-            if( i == j )
+            if( k == 1 )
+            {
+                seed_probe( w, w.seed, 4 + del.len() );
                 continue;
+            }
+
+            waves_gen::word_delete del2( &w.seed[4], del.len(), i, n - 1 );
+            while( del2.next() )
+                seed_probe( w, w.seed, 4 + del2.len() );
+        }
+    } );
+}
+
+void typo_word_dup( const char * title, size_t )
+{
+    size_t n = g_words.size();
+    typo_run( title, n + 1, false, [&]( typo_worker & w, size_t i )
+    {
+        uint8_t * text = &w.seed[4];
+        size_t at = i < n ? waves_gen::word_start( text, g_seed_len, i ) : g_seed_len;
+        waves_gen::word_insert add( text, g_seed_len, at, i == n, &g_words[0], 0, n );
+        while( add.next() )
+            seed_probe( w, w.seed, 4 + add.len() );
+    } );
+}
 
-            if( s )
-                seed[4 + s++] = ' ';
+void typo_letter_miss( const char * title, size_t k )
+{
+    typo_run( title, k == 1 ? g_seed_len : g_seed_len - 1, false, [&]( typo_worker & w, size_t i )
+    {
+        size_t pos = k == 1 ? g_seed_len - 1 - i : i;
+        waves_gen::letter_delete del( &w.seed[4], g_seed_len, pos, pos + 1 );
+        while( del.next() )
+        {
+            if( k == 1 )
+            {
+                seed_probe( w, w.seed, 4 + del.len() );
+                continue;
+            }
 
-            memcpy( &seed[4 + s], &words[j][0], words[j].size() );
-            s += words[j].size();
+            waves_gen::letter_delete del2( &w.seed[4], del.len(), i, del.len() );
+            while( del2.next() )
+                seed_probe( w, w.seed, 4 + del2.len() );
         }
+    } );
+}
 
-        seed_probe( seed, 4 + s );
-    }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
+void typo_letter_add( const char * title, size_t )
+{
+    typo_run( title, g_seed_len + 1, false, [&]( typo_worker & w, size_t i )
+    {
+        size_t pos = g_seed_len - i;
+        waves_gen::letter_insert add( &w.seed[4], g_seed_len, pos, pos + 1, g_english );
+        while( add.next() )
+            seed_probe( w, w.seed, 4 + add.len() );
+    } );
+}
 
-    // 2 WORDS MISS
-    std::cout << "2 WORDS MISS... ";
-    for( size_t i = 0; i < words.size(); i++ )
-    for( size_t ii = i + 1; ii < words.size(); ii++ )
+void typo_letter_typo( const char * title, size_t k )
+{
+    typo_run( title, g_seed_len, k == 2, [&]( typo_worker & w, size_t i )
     {
-        size_t s = 0;
-        for( size_t j = 0; j < words.size(); j++ )
+        waves_gen::letter_substitute typo( &w.seed[4], i, i + 1, g_english );
+        while( typo.next() )
         {
-            if( i == j || ii == j )
+            if( k == 1 )
+            {
+                seed_probe( w, w.seed, 4 + g_seed_len );
                 continue;
+            }
 
-            if( s )
-                seed[4 + s++] = ' ';
+            waves_gen::letter_substitute typo2( &w.seed[4], i + 1, g_seed_len, g_english );
+            while( typo2.next() )
+                seed_probe( w, w.seed, 4 + g_seed_len );
+        }
+    } );
+}
+
+// fused: the typo cursor runs inside every state of the miss cursor, one pass over both
+void typo_letter_miss_typo( const char * title, size_t )
+{
+    typo_run( title, g_seed_len, true, [&]( typo_worker & w, size_t i )
+    {
+        size_t pos = g_seed_len - 1 - i;
+        waves_gen::letter_delete del( &w.seed[4], g_seed_len, pos, pos + 1 );
+        while( del.next() )
+        {
+            waves_gen::letter_substitute typo( &w.seed[4], 0, del.len(), g_english );
+            while( typo.next() )
+                seed_probe( w, w.seed, 4 + del.len() );
+        }
+    } );
+}
+
+// fused: the typo cursor runs inside every state of the add cursor, one pass over both;
+// the added letter itself is not retyped, that would be just another 1 LETTER ADD
+void typo_letter_add_typo( const char * title, size_t )
+{
+    typo_run( title, g_seed_len + 1, true, [&]( typo_worker & w, size_t i )
+    {
+        size_t pos = g_seed_len - i;
+        waves_gen::letter_insert add( &w.seed[4], g_seed_len, pos, pos + 1, g_english );
+        while( add.next() )
+        {
+            waves_gen::letter_substitute typo( &w.seed[4], 0, pos, g_english );
+            while( typo.next() )
+                seed_probe( w, w.seed, 4 + add.len() );
 
-            memcpy( &seed[4 + s], &words[j][0], words[j].size() );
-            s += words[j].size();
+            waves_gen::letter_substitute typo2( &w.seed[4], pos + 1, add.len(), g_english );
+            while( typo2.next() )
+                seed_probe( w, w.seed, 4 + add.len() );
         }
+    } );
+}
+
+// letter edits best first: block ( c, i ) applies edit i and, for k = 2, pairs it with every
+// later edit j that brings the total cost to c; blocks run level by level, so every candidate
+// of cost c is hashed before any of cost c + 1, and the last level completes the edit class
+void typo_likely( const char * title, size_t k )
+{
+    size_t n = g_likely.edits.size();
+    size_t levels = k * waves_likely::max_cost + 1;
+    typo_run( title, levels * n, false, [&]( typo_worker & w, size_t step )
+    {
+        g_likely.each( &w.seed[4], k == 2, (unsigned)( step / n ), step % n, [&]( size_t len )
+        {
+            seed_probe( w, w.seed, 4 + len );
+        } );
+    } );
+}
 
-        seed_probe( seed, 4 + s );
+// writes the options of words [token, end) after pos, every combination with total distance budget
+void typo_word_fix_fill( typo_worker & w, size_t token, size_t pos, size_t budget )
+{
+    if( token == g_options.size() )
+    {
+        if( budget == 0 )
+            seed_probe( w, w.seed, 4 + pos - 1 );
+        return;
+    }
+
+    for( auto & o : g_options[token] )
+    {
+        if( o.distance > budget )
+            break;
+        memcpy( &w.seed[4 + pos], o.word.p, o.word.len );
+        w.seed[4 + pos + o.word.len] = ' ';
+        typo_word_fix_fill( w, token + 1, pos + o.word.len + 1, budget - o.distance );
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
+}
 
-    // 1 LETTER MISS
-    std::cout << "1 LETTER MISS... ";
-    for( size_t i = 1; i < g_seed_len; i++ )
+// only dict words, at most k edits in total: block ( c, f ) changes the first changed word to
+// its option f and lets the words after it make up the rest of cost c, so costs ascend and
+// every combination belongs to exactly one block; a word that is not in dict must change
+void typo_word_fix( const char * title, size_t k )
+{
+    std::vector<std::pair<size_t, size_t>> firsts;
+    for( size_t t = 0; t < g_options.size(); t++ )
+        for( size_t j = 0; j < g_options[t].size(); j++ )
+            if( g_options[t][j].distance && g_options[t][j].distance <= k )
+                firsts.push_back( { t, j } );
+
+    size_t n = firsts.size();
+    typo_run( title, k * n, false, [&]( typo_worker & w, size_t step )
     {
-        memcpy( &seed[4 + g_seed_len - i - 1], &g_seed[g_seed_len - i], i );
+        size_t c = step / n + 1;
+        size_t t = firsts[step % n].first;
+        const word_option & o = g_options[t][firsts[step % n].second];
+        if( o.distance > c )
+            return;
+        for( size_t q = 0; q < t; q++ )
+            if( g_options[q].empty() || g_options[q][0].distance )
+                return;
+
+        size_t pos = g_words[t].p - g_seed;
+        memcpy( &w.seed[4 + pos], o.word.p, o.word.len );
+        w.seed[4 + pos + o.word.len] = ' ';
+        typo_word_fix_fill( w, t + 1, pos + o.word.len + 1, c - o.distance );
+        w.reset();
+    } );
+}
 
-        seed_probe( seed, 4 + g_seed_len - 1 );
+// --rules, each one a stage of its own
+std::vector<waves_rules::rule> g_rules;
+waves_rules::context g_rule_context;
 
-        memcpy( &seed[4], g_seed, g_seed_len );
+typedef void ( *rule_function )( typo_worker & w, size_t block, const waves_rules::op * ops );
+
+template <waves_rules::kind... K>
+struct rule_kernel
+{
+    static void run( typo_worker & w, size_t block, const waves_rules::op * ops )
+    {
+        auto probe = [&]( size_t len ) { seed_probe( w, w.seed, 4 + len ); };
+        waves_rules::kernel<K...>::run( &w.seed[4], g_seed_len, ops, block, g_rule_context, probe );
     }
-    std::cout << "NO" << std::endl;
+};
+
+// the positions of the first op of a rule are its blocks
+size_t typo_rule_blocks( const waves_rules::rule & r )
+{
+    const waves_rules::op & first = r.ops[0];
+    if( first.pos != waves_rules::every || first.k == waves_rules::fold_case )
+        return 1;
+    return first.k == waves_rules::transpose || first.k == waves_rules::duplicate ? g_seed_len : g_words.size();
+}
+
+void typo_rule( const char * title, const waves_rules::rule & r )
+{
+    rule_function f = waves_rules::compile<rule_function, rule_kernel>( r );
+    const waves_rules::op & first = r.ops[0];
 
-    // 2 LETTERS MISS
-    std::cout << "2 LETTERS MISS... ";
-    for( size_t i = 0; i < g_seed_len - 1; i++ )
+    typo_run( title, typo_rule_blocks( r ), false, [&]( typo_worker & w, size_t i )
     {
-        memcpy( &seed[4 + i], &g_seed[i + 1], g_seed_len - i - 1 );
+        f( w, first.pos == waves_rules::every ? i : waves_rules::every, r.ops.data() );
+    } );
+}
 
-        for( size_t j = i; j < g_seed_len - 1; j++ )
-        {
-            memcpy( &seed[4 + j], &g_seed[j + 2], g_seed_len - j - 1 );
+// upper bounds of the candidates a stage generates, before the canonical skips
+uint64_t typo_count_word_miss( size_t ) { return ( g_words.size() + 1 ) * (uint64_t)g_dict.size(); }
+uint64_t typo_count_word_add_last( size_t k ) { return k == 1 ? g_dict.size() : g_dict.size() * (uint64_t)( g_dict.size() - 1 ); }
+uint64_t typo_count_word_drop( size_t k ) { size_t n = g_words.size(); return k == 1 ? n : n * (uint64_t)( n - 1 ) / 2; }
+uint64_t typo_count_word_dup( size_t ) { return ( g_words.size() + 1 ) * (uint64_t)g_words.size(); }
+uint64_t typo_count_letter_miss( size_t k ) { return k == 1 ? g_seed_len : g_seed_len * (uint64_t)( g_seed_len - 1 ) / 2; }
+uint64_t typo_count_letter_add( size_t ) { return ( g_seed_len + 1 ) * (uint64_t)( sizeof( g_english ) - 1 ); }
 
-            seed_probe( seed, 4 + g_seed_len - 2 );
+uint64_t typo_count_letter_typo( size_t k )
+{
+    uint64_t a = sizeof( g_english ) - 2;
+    return k == 1 ? g_seed_len * a : g_seed_len * (uint64_t)( g_seed_len - 1 ) / 2 * a * a;
+}
 
-            memcpy( &seed[4 + i], &g_seed[i + 1], g_seed_len - i - 1 );
-        }
+uint64_t typo_count_letter_miss_typo( size_t )
+{
+    return g_seed_len * (uint64_t)( g_seed_len - 1 ) * ( sizeof( g_english ) - 2 );
+}
 
-        memcpy( &seed[4], g_seed, g_seed_len );
+uint64_t typo_count_letter_add_typo( size_t )
+{
+    uint64_t a = sizeof( g_english ) - 1;
+    return ( g_seed_len + 1 ) * (uint64_t)g_seed_len * a * ( a - 1 );
+}
+
+// exact: the product of the per word distance histograms, cost 1..k
+uint64_t typo_count_word_fix( size_t k )
+{
+    std::vector<uint64_t> ways( k + 1 );
+    ways[0] = 1;
+    for( auto & options : g_options )
+    {
+        std::vector<uint64_t> next( k + 1 );
+        for( auto & o : options )
+            for( size_t c = 0; c + o.distance <= k; c++ )
+                next[c + o.distance] += ways[c];
+        ways.swap( next );
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
 
-    // 1 WORD ADD
-    std::cout << "1 WORD ADD... ";
-    for( size_t i = 0; i < words.size() + 1; i++ )
-    for( size_t k = 0; k < words.size(); k++ )
+    uint64_t count = 0;
+    for( size_t c = 1; c <= k; c++ )
+        count += ways[c];
+    return count;
+}
+
+// the most candidates one block ( c, f ) makes: the combinations of the words after f with
+// the rest of the budget, from the per word distance histograms taken from the last word on
+uint64_t typo_block_word_fix( size_t k )
+{
+    std::vector<uint64_t> ways( k + 1 );
+    ways[0] = 1;
+    uint64_t most = 0;
+    for( size_t t = g_options.size(); t-- > 0; )
     {
-        size_t s = 0;
-        for( size_t j = 0; j < words.size(); j++ )
-        {
-            if( s )
-                seed[4 + s++] = ' ';
+        for( size_t c = 0; c < k; c++ )
+            most = std::max( most, ways[c] );
+
+        std::vector<uint64_t> next( k + 1 );
+        for( auto & o : g_options[t] )
+            for( size_t c = 0; c + o.distance <= k; c++ )
+                next[c + o.distance] += ways[c];
+        ways.swap( next );
+    }
+    return most;
+}
 
-            if( i == j )
-            {
-                memcpy( &seed[4 + s], &words[k][0], words[k].size() );
-                s += words[k].size();
-                seed[4 + s++] = ' ';
-            }
+uint64_t typo_count_likely( size_t k )
+{
+    uint64_t n = g_likely.edits.size();
+    uint64_t a = sizeof( g_english ) - 1;
+    uint64_t doubles = std::count_if( g_likely.edits.begin(), g_likely.edits.end(), []( const waves_likely::edit & e ) { return g_likely.run_erase( e ); } );
+    return k == 1 ? n : n + n * ( n - 1 ) / 2 + ( g_seed_len + 1 ) * a * ( a + 1 ) / 2 + doubles;
+}
+
+// stages of one family can make the same candidates, a rule can make those of any stage
+enum typo_family { family_words, family_letters, family_any };
+
+struct typo_strategy
+{
+    const char * name;
+    const char * title[5]; // by k, nullptr where k is not supported
+    uint64_t ( *count )( size_t k );
+    void ( *run )( const char * title, size_t k );
+    bool nested; // stage k already makes the candidates of the stages below it
+    typo_family family;
+    bool repeats; // a stage makes some of its candidates twice
+    bool overlaps; // a stage makes some candidates of the other stages of its family
+};
+
+// word-add-last:1 makes exactly the tail block of word-miss, so the two overlap
+static const typo_strategy g_strategies[] =
+{
+    { "word-miss", { nullptr, "1 WORD MISS" }, typo_count_word_miss, typo_word_miss, false, family_words, false, false },
+    { "word-add-last", { nullptr, "1 LAST WORD ADD", "2 LAST WORDS ADD" }, typo_count_word_add_last, typo_word_add_last, false, family_words, false, true },
+    { "word-drop", { nullptr, "1 WORD DROP", "2 WORDS DROP" }, typo_count_word_drop, typo_word_drop, false, family_words, false, false },
+    { "word-dup", { nullptr, "1 WORD ADD" }, typo_count_word_dup, typo_word_dup, false, family_words, true, true },
+    { "letter-miss", { nullptr, "1 LETTER MISS", "2 LETTERS MISS" }, typo_count_letter_miss, typo_letter_miss, false, family_letters, false, false },
+    { "letter-add", { nullptr, "1 LETTER ADD" }, typo_count_letter_add, typo_letter_add, false, family_letters, false, false },
+    { "letter-typo", { nullptr, "1 LETTER TYPO", "2 LETTERS TYPO" }, typo_count_letter_typo, typo_letter_typo, false, family_letters, false, false },
+    { "letter-miss+letter-typo", { nullptr, "1 LETTER MISS + 1 LETTER TYPO" }, typo_count_letter_miss_typo, typo_letter_miss_typo, false, family_letters, true, true },
+    { "letter-add+letter-typo", { nullptr, "1 LETTER ADD + 1 LETTER TYPO" }, typo_count_letter_add_typo, typo_letter_add_typo, false, family_letters, true, true },
+    { "likely", { nullptr, "1 LIKELY LETTER EDIT", "UP TO 2 LIKELY LETTER EDITS" }, typo_count_likely, typo_likely, true, family_letters, true, true },
+    { "word-fix", { nullptr, "DICT WORDS 1 EDIT AWAY", "DICT WORDS UP TO 2 EDITS AWAY", "DICT WORDS UP TO 3 EDITS AWAY", "DICT WORDS UP TO 4 EDITS AWAY" }, typo_count_word_fix, typo_word_fix, true, family_letters, false, true },
+};
+
+struct typo_stage
+{
+    const typo_strategy * strategy; // nullptr for a rule
+    size_t k; // the index in g_rules for a rule
+    uint64_t count;
+    std::string title;
+    bool dedupe; // its candidates go through g_dedupe
+};
+
+const typo_strategy * typo_find( const std::string & name )
+{
+    for( auto & s : g_strategies )
+        if( name == s.name )
+            return &s;
+    return nullptr;
+}
+
+// parses "name[:k],..." into stages ordered by their candidate count, cheapest first;
+// a stage makes exactly k edits, so name:2 brings in name:1 (unless the strategy is nested)
+// and a fused a+b brings in a and b to keep covering the candidates with fewer edits
+bool typo_plan( const std::string & list, std::vector<typo_stage> & plan )
+{
+    auto add = [&]( const typo_strategy * strategy, size_t k )
+    {
+        for( auto & stage : plan )
+            if( stage.strategy == strategy && stage.k == k )
+                return;
+        plan.push_back( { strategy, k, strategy->count( k ), strategy->title[k], false } );
+    };
+
+    std::istringstream split( list );
+    for( std::string item; std::getline( split, item, ',' ); )
+    {
+        size_t colon = item.find( ':' );
+        std::string name = item.substr( 0, colon );
+        size_t k = colon == std::string::npos ? 1 : strtoul( item.c_str() + colon + 1, nullptr, 10 );
 
-            memcpy( &seed[4 + s], &words[j][0], words[j].size() );
-            s += words[j].size();
+        const typo_strategy * strategy = typo_find( name );
+        if( !strategy || k < 1 || k >= sizeof( strategy->title ) / sizeof( *strategy->title ) || !strategy->title[k] )
+        {
+            std::cout << "ERROR: unknown strategy \"" << item << "\"" << std::endl;
+            return false;
         }
 
-        if( i == words.size() )
+        for( size_t i = strategy->nested ? k : 1; i <= k; i++ )
+            add( strategy, i );
+
+        size_t plus = name.find( '+' );
+        if( plus != std::string::npos )
         {
-            seed[4 + s++] = ' ';
-            memcpy( &seed[4 + s], &words[k][0], words[k].size() );
-            s += words[k].size();
+            add( typo_find( name.substr( 0, plus ) ), 1 );
+            add( typo_find( name.substr( plus + 1 ) ), 1 );
         }
+    }
+
+    for( size_t i = 0; i < g_rules.size(); i++ )
+        plan.push_back( { nullptr, i, waves_rules::estimate( g_rules[i], g_seed_len, g_words.size(), g_dict.size(), g_dict.back().len ), "RULE " + g_rules[i].text, false } );
 
-        seed_probe( seed, 4 + s );
+    std::stable_sort( plan.begin(), plan.end(), []( const typo_stage & a, const typo_stage & b ) { return a.count < b.count; } );
+
+    // fingerprints only where a candidate can come twice: a stage that repeats itself, and
+    // every pair of stages of one family where one of them overlaps the others
+    auto family = []( const typo_stage & s ) { return s.strategy ? s.strategy->family : family_any; };
+    auto repeats = []( const typo_stage & s ) { return !s.strategy || s.strategy->repeats; };
+    auto overlaps = []( const typo_stage & s ) { return !s.strategy || s.strategy->overlaps; };
+    for( auto & a : plan )
+    {
+        a.dedupe = repeats( a );
+        for( auto & b : plan )
+            if( &a != &b && ( family( a ) == family( b ) || family( a ) == family_any || family( b ) == family_any ) && ( overlaps( a ) || overlaps( b ) ) )
+                a.dedupe = true;
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
 
-    // 1 LETTER ADD
-    std::cout << "1 LETTER ADD... ";
-    for( size_t i = 0; i < g_seed_len - 1; i++ )
+    // the ordinal of a candidate index has 32 bits; the other strategies stay far below per block
+    for( auto & stage : plan )
     {
-        memcpy( &seed[4 + g_seed_len - i], &g_seed[g_seed_len - i - 1], i + 1 );
-        for( size_t j = 0; j < sizeof( g_english ) - 1; j++ )
+        uint64_t most = 0;
+        if( !stage.strategy )
+            most = stage.count / std::max<size_t>( 1, typo_rule_blocks( g_rules[stage.k] ) );
+        else if( stage.strategy->run == typo_word_fix )
+            most = typo_block_word_fix( stage.k );
+        if( most > max_ordinal )
         {
-            seed[4 + g_seed_len - i - 1] = g_english[j];
-
-            seed_probe( seed, 4 + g_seed_len + 1 );
+            std::cout << "ERROR: " << stage.title << " makes up to " << most << " candidates in one block, more than 2^32; use a smaller k, or give the rule positions" << std::endl;
+            return false;
         }
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
+    return true;
+}
+
+// block 0, then every stage of the plan, each limited to the blocks typo_wanted() accepts
+void typo_search( const std::vector<typo_stage> & plan )
+{
+    g_block_base = 1;
+    g_dedupe = g_dedupe_table;
+    if( typo_wanted( 0 ) )
+    {
+        typo_worker w;
+        seed_probe( w, w.seed, 4 + g_seed_len );
+        seed_flush( w );
+        g_probes += w.generated - w.skipped;
+        typo_completed( 0, 1 );
+    }
 
-    // 1 LETTER TYPO
-    std::cout << "1 LETTER TYPO... ";
-    for( size_t i = 0; i < g_seed_len; i++ )
+    for( auto & stage : plan )
     {
-        char c = seed[4 + i];
-        for( size_t j = 0; j < sizeof( g_english ) - 1; j++ )
+        g_stage_candidates = stage.count;
+        g_dedupe = stage.dedupe ? g_dedupe_table : nullptr;
+        if( stage.strategy )
+            stage.strategy->run( stage.title.c_str(), stage.k );
+        else
+            typo_rule( stage.title.c_str(), g_rules[stage.k] );
+    }
+}
+
+// --input: a mapped file, or stdin when it is not open
+waves_input::mapping g_input;
+
+// every line of the input is a candidate, the lines starting in one block_size of input form a block
+void input_search( const char * path )
+{
+    g_block_base = 1;
+    g_dedupe = g_dedupe_table;
+    auto block = [&]( typo_worker & w, const char * data, size_t size, size_t begin )
+    {
+        waves_input::lines( data, size, begin, begin + waves_input::block_size, [&]( const char * line, size_t len )
         {
-            seed[4 + i] = g_english[j];
+            seed_probe_text( w, line, len );
+        } );
+    };
 
-            seed_probe( seed, 4 + g_seed_len );
+    if( strcmp( path, "-" ) )
+    {
+        if( g_progress )
+            g_stage_candidates = std::count( g_input.data(), g_input.data() + g_input.size(), '\n' );
+        std::string title = "LINES OF " + std::string( path );
+        typo_run( title.c_str(), ( g_input.size() + waves_input::block_size - 1 ) / waves_input::block_size, false, [&]( typo_worker & w, size_t i )
+        {
+            block( w, g_input.data(), g_input.size(), i * waves_input::block_size );
+        } );
+        return;
+    }
+
+    // stdin: windows of whole blocks, each one a typo_run of its own
+    waves_input::stream in( stdin );
+    for( size_t window = 64 * waves_input::block_size; !g_found; )
+    {
+        in.fill( window );
+        size_t blocks = in.ready();
+        if( blocks == 0 )
+        {
+            if( in.eof() )
+                break;
+            window *= 2; // a line longer than the window
+            continue;
         }
-        seed[4 + i] = c;
+
+        if( g_progress )
+            g_stage_candidates = std::count( in.data() + in.start(), in.data() + in.size(), '\n' );
+        std::string title = "LINES OF STDIN FROM " + std::to_string( in.offset() );
+        typo_run( title.c_str(), blocks, false, [&]( typo_worker & w, size_t i )
+        {
+            block( w, in.data(), in.size(), in.start() + i * waves_input::block_size );
+        } );
+        in.drop( blocks );
     }
-    std::cout << "NO" << std::endl;
+}
+
+// hands the blocks of search out to --worker processes until every target is found or every block is done
+int fleet_coordinate( const char * address, const std::function<void()> & search, const std::string & signature, uint64_t lease )
+{
+    g_range_end = 0; // counts the blocks without hashing any
+    search();
+    uint64_t blocks = g_block_base;
+    g_range_end = no_index;
 
-    // 1 LETTER MISS + 1 LETTER TYPO
-    std::cout << "1 LETTER MISS + 1 LETTER TYPO... " << g_seed_len - 1 << "... ";
-    for( size_t i = 1; i < g_seed_len; i++ )
+    waves_fleet::socket_t listener = waves_fleet::open_socket( address, true );
+    if( listener == waves_fleet::bad_socket )
     {
-        memcpy( &seed[4 + g_seed_len - i - 1], &g_seed[g_seed_len - i], i );
+        std::cout << "ERROR: cannot listen on " << address << std::endl;
+        return 1;
+    }
 
-        for( size_t k = 0; k < g_seed_len - 1; k++ )
+    waves_fleet::coordinator fleet( signature, g_targets.size(), lease, 30000 );
+    for( uint64_t begin = 0; begin < blocks; )
+    {
+        uint64_t end = begin;
+        while( end < blocks && typo_wanted( end ) )
+            end++;
+        fleet.add( begin, end );
+        begin = end + 1;
+    }
+
+    std::cout << "fleet: coordinating " << blocks << " blocks on " << address << std::endl;
+    fleet.run( listener,
+        []( const waves_fleet::range & r )
         {
-            char c2 = seed[4 + k];
-            for( size_t m = 0; m < sizeof( g_english ) - 1; m++ )
-            {
-                seed[4 + k] = g_english[m];
+            typo_completed( r.first, r.second );
+        },
+        []( size_t target, uint64_t index, const std::string & seed )
+        {
+            if( seed_report( seed.c_str(), target, index ) )
+                g_found_count++;
+        } );
+
+    waves_fleet::close_socket( listener );
+    if( g_checkpointing )
+        g_checkpoint.save();
+    if( g_found_count == g_targets.size() )
+        g_found = true;
+    return 0;
+}
 
-                seed_probe( seed, 4 + g_seed_len - 1 );
-            }
-            seed[4 + k] = c2;
+// hashes the leases a coordinator hands out until it says STOP
+int fleet_work( const char * address, const std::function<void()> & search, const std::string & signature )
+{
+    waves_fleet::client client;
+    if( !client.start( address, signature, []() -> uint64_t { return g_probes; }, []() { g_found = true; } ) )
+    {
+        std::cout << "ERROR: cannot connect to " << address << std::endl;
+        return 1;
+    }
+
+    std::cout << "fleet: working for " << address << std::endl;
+    g_client = &client;
+    g_quiet = true;
+    for( waves_fleet::range lease; !g_found && client.next_lease( lease ); )
+    {
+        g_range_begin = lease.first;
+        g_range_end = lease.second;
+        search();
+        if( !g_found )
+            client.done( lease );
+    }
+
+    bool lost = client.lost();
+    client.close();
+    g_client = nullptr;
+    if( lost )
+    {
+        std::cout << "ERROR: lost the coordinator at " << address << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+void add_target( const char * address )
+{
+    alignas( 128 ) uint8_t decoded[128];
+    uint8_t * buf = decoded;
+    size_t len = sizeof( decoded );
+    d58( address, strlen( address ), &buf, &len );
+
+    if( buf[0] != waves_address::version ||
+        buf[1] != g_chain ||
+        memcmp( &buf[22], g_waves_crypto.sechash( buf, 22 ), 4 ) )
+    {
+        std::cout << "Bad address for chain '" << (char)g_chain << "': " << address << std::endl;
+        exit( 1 );
+    }
+
+    if( g_targets.add( &buf[2] ) != waves_targets::npos )
+        g_addresses.push_back( address );
+}
+
+// one address per line, blank lines and # comments skipped
+void add_targets( const char * path )
+{
+    std::ifstream file( path );
+    if( !file )
+    {
+        std::cout << "ERROR: cannot read " << path << std::endl;
+        exit( 1 );
+    }
+
+    for( std::string line; std::getline( file, line ); )
+    {
+        size_t first = line.find_first_not_of( " \t\r" );
+        if( first == std::string::npos || line[first] == '#' )
+            continue;
+
+        add_target( line.substr( first, line.find_last_not_of( " \t\r" ) + 1 - first ).c_str() );
+    }
+}
+
+// checks the fixed-base X25519 engine against curve25519_donna on random scalars
+bool selftest_x25519( std::mt19937_64 & rng, size_t rounds )
+{
+    const size_t batch = 16;
+    uint8_t scalar[batch][32], fixed[batch][32], donna[32];
+    uint8_t * out[batch];
+    const uint8_t * in[batch];
+
+    for( size_t r = 0; r < rounds; r++ )
+    {
+        size_t count = r % batch + 1;
+        for( size_t i = 0; i < count; i++ )
+        {
+            for( auto & c : scalar[i] )
+                c = (uint8_t)rng();
+            in[i] = scalar[i];
+            out[i] = fixed[i];
         }
 
-        std::cout << g_seed_len - i - 1 << "... ";
+        waves_x25519::scalarmult_base_xN( out, in, count );
+        for( size_t i = 0; i < count; i++ )
+        {
+            Botan::curve25519_donna( donna, scalar[i], g_base9 );
+            if( memcmp( donna, fixed[i], 32 ) )
+                return false;
+        }
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
 
-    // 2 LETTERS TYPO
-    std::cout << "2 LETTERS TYPO... " << g_seed_len << "... ";
-    for( size_t i = 0; i < g_seed_len; i++ )
+    return true;
+}
+
+std::vector<uint8_t> from_hex( const char * hex )
+{
+    std::vector<uint8_t> bin;
+    for( ; hex[0] && hex[1]; hex += 2 )
+        bin.push_back( (uint8_t)std::stoi( std::string( hex, 2 ), nullptr, 16 ) );
+    return bin;
+}
+
+// known answers of the Botan hashes, then the fixed-length kernels against Botan on every length they cover
+bool selftest_hashes( std::mt19937_64 & rng )
+{
+    static const struct { const char * in; const char * blake2b256; const char * keccak256; const char * sha256; } kat[] =
+    {
+        {
+            "0000000000000000000000000000000000000000000000000000000000000000",
+            "89eb0d6a8a691dae2cd15ed0369931ce0a949ecafa5c3f93f8121833646e15c3",
+            "290decd9548b62a8d60345a988386fc84ba6bc95484008f6362f93160ef3e563",
+            "66687aadf862bd776c8fc18b8e9f8e20089714856ee233b3902a591d0d5f2925",
+        },
+        {
+            "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f",
+            nullptr,
+            "8ae1aa597fa146ebd3aa2ceddf360668dea5e526567e92b0321816a4e895bd2d",
+            "630dcd2966c4336691125448bbb25b4ff412a49c732db2c8abc1b8581bd710dd",
+        },
+        {
+            "616263",
+            "bddd813c634239723171ef3fee98579b94964e3bb1cb3e427262c8c068d52319",
+            nullptr,
+            nullptr,
+        },
+    };
+
+    botan_hashes botan;
+    fixed_hashes fixed;
+    uint8_t a[32], b[32];
+
+    for( auto & k : kat )
     {
-        char c1 = seed[4 + i];
-        for( size_t j = 0; j < sizeof( g_english ) - 1; j++ )
+        auto in = from_hex( k.in );
+        if( k.blake2b256 )
         {
-            seed[4 + i] = g_english[j];
+            botan.blake2b256( in.data(), in.size(), a );
+            fixed.blake2b256( in.data(), in.size(), b );
+            if( from_hex( k.blake2b256 ) != std::vector<uint8_t>( a, a + 32 ) || memcmp( a, b, 32 ) )
+                return false;
+        }
+        if( k.keccak256 )
+        {
+            botan.keccak256( in.data(), in.size(), a );
+            fixed.keccak256( in.data(), in.size(), b );
+            if( from_hex( k.keccak256 ) != std::vector<uint8_t>( a, a + 32 ) || memcmp( a, b, 32 ) )
+                return false;
+        }
+        if( k.sha256 )
+        {
+            botan.sha256( in.data(), in.size(), a );
+            fixed.sha256( in.data(), in.size(), b );
+            if( from_hex( k.sha256 ) != std::vector<uint8_t>( a, a + 32 ) || memcmp( a, b, 32 ) )
+                return false;
+        }
+    }
 
-            for( size_t k = i + 1; k < g_seed_len; k++ )
-            {
-                char c2 = seed[4 + k];
-                for( size_t m = 0; m < sizeof( g_english ) - 1; m++ )
-                {
-                    seed[4 + k] = g_english[m];
+    uint8_t in[128];
+    for( size_t len = 0; len <= 128; len++ )
+    {
+        for( auto & c : in )
+            c = (uint8_t)rng();
+
+        botan.blake2b256( in, len, a );
+        fixed.blake2b256( in, len, b );
+        if( memcmp( a, b, 32 ) )
+            return false;
+
+        botan.keccak256( in, 32, a );
+        fixed.keccak256( in, 32, b );
+        if( memcmp( a, b, 32 ) )
+            return false;
+
+        botan.sha256( in, 32, a );
+        fixed.sha256( in, 32, b );
+        if( memcmp( a, b, 32 ) )
+            return false;
+    }
 
-                    seed_probe( seed, 4 + g_seed_len );
-                }
-                seed[4 + k] = c2;
-            }
+    return true;
+}
+
+// derive_addresses on every isa against the scalar chain, the addresses decoded back with d58
+bool selftest_address( std::mt19937_64 & rng, waves_simd::isa cpu )
+{
+    std::vector<std::string> texts;
+    for( size_t len = 0; len < 300; len += 1 + rng() % 13 )
+    {
+        texts.emplace_back( len, ' ' );
+        for( auto & c : texts.back() )
+            c = g_english[rng() % ( sizeof( g_english ) - 1 )];
+    }
+
+    std::vector<waves_address::seed> seeds;
+    for( auto & t : texts )
+        seeds.push_back( { t.data(), t.size() } );
+
+    for( uint8_t chain : { waves_address::mainnet, waves_address::testnet } )
+    {
+        uint32_t nonce = chain == waves_address::mainnet ? 0 : (uint32_t)rng();
+        std::vector<waves_address::address> expected( seeds.size() ), out( seeds.size() );
+        for( int isa = waves_simd::isa_none; isa <= cpu; isa++ )
+        {
+            waves_address::deriver d( waves_simd::select( (waves_simd::isa)isa ) );
+            d.derive( seeds, nonce, chain, out.data() );
+            if( isa == waves_simd::isa_none )
+                expected = out;
+
+            for( size_t i = 0; i < seeds.size(); i++ )
+                if( strcmp( expected[i].text, out[i].text ) )
+                    return false;
         }
-        seed[4 + i] = c1;
 
-        std::cout << g_seed_len - i - 1 << "... ";
+        for( size_t i = 0; i < seeds.size(); i++ )
+        {
+            std::vector<uint8_t> data( 4 + texts[i].size() );
+            waves_address::put_nonce( data.data(), nonce );
+            memcpy( data.data() + 4, texts[i].data(), texts[i].size() );
+            uint8_t hash[32];
+            memcpy( hash, g_waves_crypto.pubsechash( data.data(), data.size() ), 32 );
+
+            alignas( 128 ) uint8_t decoded[128];
+            uint8_t * buf = decoded;
+            size_t len = sizeof( decoded );
+            d58( expected[i].text, strlen( expected[i].text ), &buf, &len );
+            if( buf[0] != waves_address::version || buf[1] != chain || memcmp( &buf[2], hash, 20 ) ||
+                memcmp( &buf[22], g_waves_crypto.sechash( buf, 22 ), 4 ) )
+                return false;
+        }
     }
-    std::cout << "NO" << std::endl;
 
-    // 1 LETTER ADD + 1 LETTER TYPO
-    std::cout << "1 LETTER ADD + 1 LETTER TYPO... " << g_seed_len - 1 << "... ";
-    for( size_t i = 0; i < g_seed_len - 1; i++ )
+    return true;
+}
+
+// every string within one edit of text over g_english, text itself included
+void selftest_edits( const std::string & text, std::unordered_set<std::string> & out )
+{
+    out.insert( text );
+    for( size_t pos = 0; pos <= text.size(); pos++ )
     {
-        memcpy( &seed[4 + g_seed_len - i], &g_seed[g_seed_len - i - 1], i + 1 );
-        for( size_t j = 0; j < sizeof( g_english ) - 1; j++ )
+        if( pos < text.size() )
+            out.insert( text.substr( 0, pos ) + text.substr( pos + 1 ) );
+        for( const char * c = g_english; *c; c++ )
         {
-            seed[4 + g_seed_len - i - 1] = g_english[j];
+            out.insert( text.substr( 0, pos ) + *c + text.substr( pos ) );
+            if( pos < text.size() )
+                out.insert( text.substr( 0, pos ) + *c + text.substr( pos + 1 ) );
+        }
+    }
+}
 
-            for( size_t k = 0; k < g_seed_len + 1; k++ )
+// likely:2 against every string within two edits, on seeds with double letters and runs
+bool selftest_likely()
+{
+    static const char * seeds[] = { "hello zoo", "aab bb", "lll a", "moon sleep" };
+    std::unordered_set<std::string> words( std::begin( dict ), std::end( dict ) );
+    for( const char * seed : seeds )
+    {
+        std::string text = seed;
+        waves_likely::model m;
+        m.build( (const uint8_t *)text.data(), text.size(), g_english, words );
+
+        std::unordered_set<std::string> made;
+        std::vector<uint8_t> buf( text.size() + 2 );
+        for( unsigned c = 0; c <= 2 * waves_likely::max_cost; c++ )
+            for( size_t i = 0; i < m.edits.size(); i++ )
             {
-                char c2 = seed[4 + k];
-                for( size_t m = 0; m < sizeof( g_english ) - 1; m++ )
+                memcpy( buf.data(), text.data(), text.size() );
+                m.each( buf.data(), true, c, i, [&]( size_t len )
                 {
-                    seed[4 + k] = g_english[m];
+                    made.insert( std::string( (const char *)buf.data(), len ) );
+                } );
+            }
 
-                    seed_probe( seed, 4 + g_seed_len + 1 );
-                }
-                seed[4 + k] = c2;
+        std::unordered_set<std::string> one, two;
+        selftest_edits( text, one );
+        for( auto & t : one )
+            selftest_edits( t, two );
+        two.erase( text );
+        made.erase( text );
+        if( made != two )
+            return false;
+    }
+    return true;
+}
+
+int selftest()
+{
+    std::mt19937_64 rng( std::random_device{}() );
+    bool hashes = selftest_hashes( rng );
+    std::cout << "fixed-length hash kernels vs Botan: " << ( hashes ? "OK" : "FAIL" ) << std::endl;
+    bool x25519 = selftest_x25519( rng, 1000 );
+    std::cout << "x25519 fixed-base vs curve25519_donna: " << ( x25519 ? "OK" : "FAIL" ) << std::endl;
+    bool address = selftest_address( rng, waves_simd::detect() );
+    std::cout << "derive_addresses batched vs scalar and d58: " << ( address ? "OK" : "FAIL" ) << std::endl;
+    bool likely = selftest_likely();
+    std::cout << "likely:2 vs every string within two edits: " << ( likely ? "OK" : "FAIL" ) << std::endl;
+    return hashes && x25519 && address && likely ? 0 : 1;
+}
+
+int main( int argc, char ** argv )
+{
+    std::cout << "waves-typo (" << __DATE__ << ")" << std::endl;
+
+    g_threads = std::thread::hardware_concurrency();
+    auto cpu = waves_simd::detect();
+    auto isa = cpu;
+    std::string strategies;
+    const char * addresses = nullptr;
+    const char * checkpoint = nullptr;
+    const char * coordinator = nullptr;
+    const char * worker = nullptr;
+    const char * input = nullptr;
+    uint64_t lease = 16;
+    std::vector<char *> args;
+    for( int i = 1; i < argc; i++ )
+    {
+        if( 0 == strcmp( argv[i], "--selftest" ) )
+            return selftest();
+        else if( 0 == strncmp( argv[i], "--threads=", 10 ) )
+            g_threads = strtoul( argv[i] + 10, nullptr, 10 );
+        else if( 0 == strncmp( argv[i], "--addresses=", 12 ) )
+            addresses = argv[i] + 12;
+        else if( 0 == strcmp( argv[i], "--stats" ) )
+            g_stats = true;
+        else if( 0 == strcmp( argv[i], "--progress" ) )
+            g_progress = true;
+        else if( 0 == strncmp( argv[i], "--checkpoint=", 13 ) )
+            checkpoint = argv[i] + 13;
+        else if( 0 == strncmp( argv[i], "--coordinator=", 14 ) )
+            coordinator = argv[i] + 14;
+        else if( 0 == strncmp( argv[i], "--worker=", 9 ) )
+            worker = argv[i] + 9;
+        else if( 0 == strncmp( argv[i], "--lease=", 8 ) )
+            lease = std::max<uint64_t>( 1, strtoull( argv[i] + 8, nullptr, 10 ) );
+        else if( 0 == strncmp( argv[i], "--candidate=", 12 ) )
+            g_locate = strtoull( argv[i] + 12, nullptr, 10 );
+        else if( 0 == strncmp( argv[i], "--shard=", 8 ) )
+        {
+            char * slash;
+            g_shard = strtoull( argv[i] + 8, &slash, 10 );
+            g_shards = *slash == '/' ? strtoull( slash + 1, nullptr, 10 ) : 0;
+            if( g_shard < 1 || g_shard > g_shards )
+            {
+                std::cout << "ERROR: bad shard \"" << argv[i] + 8 << "\", expected k/n with 1 <= k <= n" << std::endl;
+                return 1;
             }
+            g_shard--;
+        }
+        else if( 0 == strncmp( argv[i], "--nonce=", 8 ) )
+            g_nonce = (uint32_t)strtoul( argv[i] + 8, nullptr, 10 );
+        else if( 0 == strncmp( argv[i], "--chain=", 8 ) && strlen( argv[i] ) == 9 )
+            g_chain = (uint8_t)argv[i][8];
+        else if( 0 == strncmp( argv[i], "--input=", 8 ) )
+            input = argv[i] + 8;
+        else if( 0 == strncmp( argv[i], "--strategies=", 13 ) )
+            strategies = argv[i] + 13;
+        else if( 0 == strncmp( argv[i], "--rules=", 8 ) )
+        {
+            std::string error;
+            if( !waves_rules::parse( argv[i] + 8, g_rules, error ) )
+            {
+                std::cout << "ERROR: " << error << std::endl;
+                return 1;
+            }
+        }
+        else if( 0 == strncmp( argv[i], "--simd=", 7 ) )
+        {
+            std::string name = argv[i] + 7;
+            isa = name == "avx2" ? waves_simd::isa_avx2 : name == "sse4.1" ? waves_simd::isa_sse41 : waves_simd::isa_none;
         }
+        else
+            args.push_back( argv[i] );
+    }
+    if( g_threads == 0 )
+        g_threads = 1;
+    if( isa > cpu )
+        isa = cpu;
+    g_simd = waves_simd::select( isa );
+
+    if( args.size() < ( addresses ? 1u : 2u ) - ( input ? 1u : 0u ) )
+    {
+        std::cout << "Usage: waves-typo [--threads=N] [--simd=none|sse4.1|avx2] [--strategies=name[:k],...] [--stats] [--progress] \"address\" \"seed\"" << std::endl;
+        std::cout << "       waves-typo [options] --addresses=FILE \"seed\"" << std::endl;
+        std::cout << "       waves-typo [options] --input=FILE|- \"address\", a candidate seed per line of FILE or stdin" << std::endl;
+        std::cout << "       options also take [--shard=k/n] [--checkpoint=FILE] [--candidate=INDEX] [--rules=RULE,...]" << std::endl;
+        std::cout << "       and [--nonce=N] [--chain=C] for seeds hashed behind another nonce or addresses of chain C, T for testnet" << std::endl;
+        std::cout << "       fleet: [--coordinator=[host:]port [--lease=BLOCKS]] or [--worker=host:port]" << std::endl;
+        std::cout << "       waves-typo --selftest" << std::endl;
+        std::cout << "Strategies (default word-miss, run cheapest first):" << std::endl;
+        for( auto & s : g_strategies )
+        {
+            std::cout << "    " << s.name;
+            for( size_t k = 2; k < sizeof( s.title ) / sizeof( *s.title ) && s.title[k]; k++ )
+                std::cout << ( k == 2 ? ":1|2" : "|" + std::to_string( k ) );
+            std::cout << std::endl;
+        }
+        std::cout << "Rules: up to " << waves_rules::max_depth << " ops of T transpose letters, D double a letter, S swap words," << std::endl;
+        std::cout << "    X drop a word, R replace a word with a dict word, L lower case; an op may take a position, as X3" << std::endl;
+        std::this_thread::sleep_for( std::chrono::seconds( 5 ) );
+        return 1;
+    }
+
+    if( addresses )
+        add_targets( addresses );
+    else
+        add_target( args[0] );
+    if( g_targets.size() == 0 )
+    {
+        std::cout << "ERROR: no addresses" << std::endl;
+        return 1;
+    }
+    g_hits.reset( new std::atomic<bool>[g_targets.size()]() );
+
+    if( input && strcmp( input, "-" ) && !g_input.open( input ) )
+    {
+        std::cout << "ERROR: cannot open " << input << std::endl;
+        return 1;
+    }
+    if( input && !strcmp( input, "-" ) && ( coordinator || worker ) )
+    {
+        std::cout << "ERROR: a fleet cannot share stdin, use --input=FILE" << std::endl;
+        return 1;
+    }
+
+    g_seed = input ? (char *)"" : args[addresses ? 0 : 1];
+    g_seed_len = strlen( g_seed );
+    if( !input && ( g_seed_len < 2 || g_seed_len * 2 + 1 > waves_gen::max_text ) )
+    {
+        std::cout << "ERROR: seed length " << g_seed_len << " is out of range" << std::endl;
+        return 1;
+    }
+    std::cout << "threads: " << g_threads << ", simd: " << waves_simd::isa_name( isa ) << ", addresses: " << g_targets.size() << std::endl;
+    if( g_nonce || g_chain != waves_address::mainnet )
+        std::cout << "nonce: " << g_nonce << ", chain: " << (char)g_chain << std::endl;
+
+    for( auto & word : dict )
+        g_dict.push_back( { word, strlen( word ) } );
+    std::stable_sort( g_dict.begin(), g_dict.end(), []( const waves_gen::word_ref & a, const waves_gen::word_ref & b ) { return a.len < b.len; } );
+
+    for( size_t i = 0, n = seed_words( g_seed, g_seed_len ); i < n; i++ )
+    {
+        size_t start = waves_gen::word_start( (uint8_t *)g_seed, g_seed_len, i );
+        g_words.push_back( { g_seed + start, waves_gen::word_end( (uint8_t *)g_seed, g_seed_len, start ) - start } );
+    }
+
+    std::unordered_set<std::string> words( std::begin( dict ), std::end( dict ) );
+    g_likely.build( (const uint8_t *)g_seed, g_seed_len, g_english, words );
+
+    waves_words::bktree bktree;
+    for( auto & word : dict )
+        bktree.add( word, strlen( word ) );
+    for( auto & word : g_words )
+    {
+        std::vector<std::pair<size_t, size_t>> found;
+        bktree.find( word.p, word.len, word_fix_max, found );
+        std::sort( found.begin(), found.end(), []( const std::pair<size_t, size_t> & a, const std::pair<size_t, size_t> & b )
+        {
+            return a.second != b.second ? a.second < b.second : a.first < b.first;
+        } );
+
+        g_options.emplace_back();
+        for( auto & f : found )
+            g_options.back().push_back( { { bktree.word( f.first ), bktree.len( f.first ) }, f.second } );
+    }
+
+    g_rule_context = { g_dict.data(), g_dict.size() };
+    if( strategies.empty() && g_rules.empty() )
+        strategies = "word-miss";
+
+    std::vector<typo_stage> plan;
+    if( !input && !typo_plan( strategies, plan ) )
+        return 1;
+
+    // the same seed, plan and addresses give the same block indexes
+    uint64_t deduped = 0; // candidates that go through the dedupe table
+    std::string signature = std::string( g_seed ) + "\n";
+    if( g_nonce )
+        signature += "nonce " + std::to_string( g_nonce ) + "\n";
+    for( auto & stage : plan )
+    {
+        std::cout << "plan: " << stage.title << " (" << stage.count << ")" << ( stage.dedupe ? ", deduped" : "" ) << std::endl;
+        deduped += stage.dedupe ? stage.count : 0;
+        signature += stage.title + "\n";
+    }
+    for( auto & address : g_addresses )
+        signature += address + "\n";
+
+    std::function<void()> search = [&]() { typo_search( plan ); };
+    if( input )
+    {
+        std::cout << "input: " << ( strcmp( input, "-" ) ? input : "stdin" ) << std::endl;
+        signature += "input " + std::string( input ) + " " + std::to_string( g_input.size() ) + "\n";
+        search = [&]() { input_search( input ); };
+        deduped = g_input.data() ? g_input.size() / 16 : 1 << 24; // about the lines of a seed list
+    }
+
+    if( g_locate != no_index )
+    {
+        search();
+        return 0;
+    }
 
-        std::cout << g_seed_len - i - 2 << "... ";
+    if( checkpoint )
+    {
+        signature += std::to_string( g_shard ) + "/" + std::to_string( g_shards );
+        if( !g_checkpoint.load( checkpoint, waves_gen::fingerprint( (const uint8_t *)signature.data(), signature.size() ) ) )
+        {
+            std::cout << "ERROR: " << checkpoint << " belongs to another search" << std::endl;
+            return 1;
+        }
+        g_checkpointing = true;
+        std::cout << "checkpoint: " << g_checkpoint.size() << " blocks done" << std::endl;
     }
-    std::cout << "NO" << std::endl;
-    memcpy( &seed[4], g_seed, g_seed_len );
+    if( g_shards > 1 )
+        std::cout << "shard: " << g_shard + 1 << "/" << g_shards << std::endl;
+
+    // shared by the deduped stages, so their overlaps with each other are caught as well
+    std::unique_ptr<waves_gen::dedupe> dedupe;
+    if( deduped )
+        dedupe.reset( new waves_gen::dedupe( 1 + deduped / g_shards ) );
+    g_dedupe_table = dedupe.get();
 
+    if( coordinator || worker )
+    {
+        std::ostringstream hex;
+        hex << std::hex << waves_gen::fingerprint( (const uint8_t *)signature.data(), signature.size() );
+        waves_fleet::startup();
+        int error = coordinator ? fleet_coordinate( coordinator, search, hex.str(), lease ) : fleet_work( worker, search, hex.str() );
+        if( error )
+            return error;
+    }
+    else
+    {
+        search();
+#ifdef WAVES_COUNT_ALLOCS
+        std::cout << "hot path heap allocations: " << g_hot_allocs << std::endl;
 #endif
+    }
+    if( g_input_skipped )
+        std::cout << "skipped " << g_input_skipped << " lines longer than " << waves_gen::max_text << " bytes" << std::endl;
+
+    if( g_failed )
+        return 1;
+    if( g_found )
+        return 0;
+
+    if( g_found_count )
+    {
+        std::cout << "FOUND " << g_found_count << " OF " << g_targets.size() << " ADDRESSES" << std::endl;
+        return 0;
+    }
 
     std::cout << "NOT FOUND" << std::endl;
     return 1;
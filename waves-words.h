@@ -0,0 +1,100 @@
+#pragma once
+
+// dictionary lookups by edit distance: a BK-tree over the words, so finding every word
+// within k edits of a token visits a small part of the dictionary instead of all of it
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace waves_words
+{
+
+// Levenshtein distance: inserts, deletes and substitutions, as the letter strategies count them
+inline size_t distance( const char * a, size_t alen, const char * b, size_t blen )
+{
+    std::vector<size_t> row( blen + 1 );
+    for( size_t j = 0; j <= blen; j++ )
+        row[j] = j;
+
+    for( size_t i = 1; i <= alen; i++ )
+    {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for( size_t j = 1; j <= blen; j++ )
+        {
+            size_t above = row[j];
+            row[j] = std::min( { above + 1, row[j - 1] + 1, diagonal + ( a[i - 1] != b[j - 1] ) } );
+            diagonal = above;
+        }
+    }
+    return row[blen];
+}
+
+// every child hangs off its parent by their distance, so by the triangle inequality a query
+// within k only descends into the children at parent distance d - k .. d + k
+struct bktree
+{
+    void add( const char * word, size_t len )
+    {
+        _nodes.push_back( { word, len, {} } );
+        if( _nodes.size() == 1 )
+            return;
+
+        for( size_t n = 0;; )
+        {
+            size_t d = distance( word, len, _nodes[n].word, _nodes[n].len );
+            if( d == 0 )
+            {
+                _nodes.pop_back();
+                return;
+            }
+
+            auto & children = _nodes[n].children;
+            auto child = std::find_if( children.begin(), children.end(), [&]( const std::pair<size_t, size_t> & c ) { return c.first == d; } );
+            if( child == children.end() )
+            {
+                children.push_back( { d, _nodes.size() - 1 } );
+                return;
+            }
+            n = child->second;
+        }
+    }
+
+    // ( node, distance ) of every word within k edits of word, see word() and len()
+    void find( const char * word, size_t len, size_t k, std::vector<std::pair<size_t, size_t>> & out ) const
+    {
+        if( _nodes.empty() )
+            return;
+
+        std::vector<size_t> stack( 1, 0 );
+        while( !stack.empty() )
+        {
+            const node & n = _nodes[stack.back()];
+            stack.pop_back();
+
+            size_t d = distance( word, len, n.word, n.len );
+            if( d <= k )
+                out.push_back( { (size_t)( &n - _nodes.data() ), d } );
+            for( auto & c : n.children )
+                if( c.first + k >= d && c.first <= d + k )
+                    stack.push_back( c.second );
+        }
+    }
+
+    const char * word( size_t index ) const { return _nodes[index].word; }
+    size_t len( size_t index ) const { return _nodes[index].len; }
+
+    struct node
+    {
+        const char * word;
+        size_t len;
+        std::vector<std::pair<size_t, size_t>> children; // ( distance, node )
+    };
+
+    std::vector<node> _nodes;
+};
+
+} // namespace waves_words
@@ -0,0 +1,448 @@
+#pragma once
+
+// fixed-base X25519: u-coordinate of a * 9, bit-identical to curve25519_donna( out, a, 9 )
+//
+// the scalar is multiplied on the birationally equivalent Edwards curve with a table of
+// j * 256^i * B for j = 1..8, then u = ( Z + Y ) / ( Z - Y ), where a batch of candidates
+// shares one field inversion through Montgomery's simultaneous-inversion trick
+//
+// NOT constant-time: the table row and the sign come from branches and indexes on the scalar
+// digits, so timing and cache state leak the private key. That is fine for searching candidate
+// seeds, whose keys are throwaway guesses; a key that must stay secret on a machine others can
+// observe belongs to curve25519_donna
+
+#include <cstdint>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace waves_x25519
+{
+
+// 64x64 -> 128-bit products for the field multiplication
+
+#if defined( _MSC_VER ) && !defined( __clang__ )
+
+struct u128
+{
+    uint64_t lo, hi;
+};
+
+inline u128 mul64( uint64_t a, uint64_t b )
+{
+    u128 r;
+    r.lo = _umul128( a, b, &r.hi );
+    return r;
+}
+
+inline u128 operator+( u128 a, u128 b )
+{
+    u128 r;
+    r.hi = a.hi + b.hi + _addcarry_u64( 0, a.lo, b.lo, &r.lo );
+    return r;
+}
+
+inline u128 operator+( u128 a, uint64_t b )
+{
+    u128 r;
+    r.hi = a.hi + _addcarry_u64( 0, a.lo, b, &r.lo );
+    return r;
+}
+
+inline uint64_t lo64( u128 a ) { return a.lo; }
+inline uint64_t shr51( u128 a ) { return __shiftright128( a.lo, a.hi, 51 ); }
+
+#else
+
+typedef unsigned __int128 u128;
+
+inline u128 mul64( uint64_t a, uint64_t b ) { return (u128)a * b; }
+inline uint64_t lo64( u128 a ) { return (uint64_t)a; }
+inline uint64_t shr51( u128 a ) { return (uint64_t)( a >> 51 ); }
+
+#endif
+
+// GF( 2^255 - 19 ) in radix 2^51, limbs stay below 2^54 between multiplications
+struct fe
+{
+    uint64_t v[5];
+};
+
+static const uint64_t mask51 = ( (uint64_t)1 << 51 ) - 1;
+
+inline fe fe_zero()
+{
+    fe h = {};
+    return h;
+}
+
+inline fe fe_one()
+{
+    fe h = {};
+    h.v[0] = 1;
+    return h;
+}
+
+inline fe add( const fe & f, const fe & g )
+{
+    fe h;
+    for( int i = 0; i < 5; i++ )
+        h.v[i] = f.v[i] + g.v[i];
+    return h;
+}
+
+// f + 4p - g keeps the limbs positive
+inline fe sub( const fe & f, const fe & g )
+{
+    fe h;
+    h.v[0] = f.v[0] + 0x1fffffffffffb4ULL - g.v[0];
+    for( int i = 1; i < 5; i++ )
+        h.v[i] = f.v[i] + 0x1ffffffffffffcULL - g.v[i];
+    return h;
+}
+
+inline fe neg( const fe & f )
+{
+    return sub( fe_zero(), f );
+}
+
+inline fe carry( fe h )
+{
+    uint64_t c;
+    c = h.v[0] >> 51; h.v[0] &= mask51; h.v[1] += c;
+    c = h.v[1] >> 51; h.v[1] &= mask51; h.v[2] += c;
+    c = h.v[2] >> 51; h.v[2] &= mask51; h.v[3] += c;
+    c = h.v[3] >> 51; h.v[3] &= mask51; h.v[4] += c;
+    c = h.v[4] >> 51; h.v[4] &= mask51; h.v[0] += c * 19;
+    return h;
+}
+
+inline fe mul( const fe & f, const fe & g )
+{
+    uint64_t f0 = f.v[0], f1 = f.v[1], f2 = f.v[2], f3 = f.v[3], f4 = f.v[4];
+    uint64_t g0 = g.v[0], g1 = g.v[1], g2 = g.v[2], g3 = g.v[3], g4 = g.v[4];
+    uint64_t g1_19 = 19 * g1, g2_19 = 19 * g2, g3_19 = 19 * g3, g4_19 = 19 * g4;
+
+    u128 r0 = mul64( f0, g0 ) + mul64( f1, g4_19 ) + mul64( f2, g3_19 ) + mul64( f3, g2_19 ) + mul64( f4, g1_19 );
+    u128 r1 = mul64( f0, g1 ) + mul64( f1, g0 ) + mul64( f2, g4_19 ) + mul64( f3, g3_19 ) + mul64( f4, g2_19 );
+    u128 r2 = mul64( f0, g2 ) + mul64( f1, g1 ) + mul64( f2, g0 ) + mul64( f3, g4_19 ) + mul64( f4, g3_19 );
+    u128 r3 = mul64( f0, g3 ) + mul64( f1, g2 ) + mul64( f2, g1 ) + mul64( f3, g0 ) + mul64( f4, g4_19 );
+    u128 r4 = mul64( f0, g4 ) + mul64( f1, g3 ) + mul64( f2, g2 ) + mul64( f3, g1 ) + mul64( f4, g0 );
+
+    fe h;
+    r1 = r1 + shr51( r0 );
+    h.v[0] = lo64( r0 ) & mask51;
+    r2 = r2 + shr51( r1 );
+    h.v[1] = lo64( r1 ) & mask51;
+    r3 = r3 + shr51( r2 );
+    h.v[2] = lo64( r2 ) & mask51;
+    r4 = r4 + shr51( r3 );
+    h.v[3] = lo64( r3 ) & mask51;
+    uint64_t c = shr51( r4 );
+    h.v[4] = lo64( r4 ) & mask51;
+    h.v[0] += c * 19;
+    h.v[1] += h.v[0] >> 51;
+    h.v[0] &= mask51;
+    return h;
+}
+
+inline fe sq( const fe & f )
+{
+    return mul( f, f );
+}
+
+inline fe sqn( fe f, int n )
+{
+    for( int i = 0; i < n; i++ )
+        f = sq( f );
+    return f;
+}
+
+// z^( p - 2 )
+inline fe invert( const fe & z )
+{
+    fe z2 = sq( z );
+    fe z9 = mul( sqn( z2, 2 ), z );
+    fe z11 = mul( z9, z2 );
+    fe z2_5_0 = mul( sq( z11 ), z9 );
+    fe z2_10_0 = mul( sqn( z2_5_0, 5 ), z2_5_0 );
+    fe z2_20_0 = mul( sqn( z2_10_0, 10 ), z2_10_0 );
+    fe z2_40_0 = mul( sqn( z2_20_0, 20 ), z2_20_0 );
+    fe z2_50_0 = mul( sqn( z2_40_0, 10 ), z2_10_0 );
+    fe z2_100_0 = mul( sqn( z2_50_0, 50 ), z2_50_0 );
+    fe z2_200_0 = mul( sqn( z2_100_0, 100 ), z2_100_0 );
+    fe z2_250_0 = mul( sqn( z2_200_0, 50 ), z2_50_0 );
+    return mul( sqn( z2_250_0, 5 ), z11 );
+}
+
+inline uint64_t load64( const uint8_t * s )
+{
+    uint64_t x = 0;
+    for( int i = 7; i >= 0; i-- )
+        x = x << 8 | s[i];
+    return x;
+}
+
+inline void store64( uint8_t * s, uint64_t x )
+{
+    for( int i = 0; i < 8; i++, x >>= 8 )
+        s[i] = (uint8_t)x;
+}
+
+inline fe frombytes( const uint8_t * s )
+{
+    fe h;
+    h.v[0] = load64( s ) & mask51;
+    h.v[1] = ( load64( s + 6 ) >> 3 ) & mask51;
+    h.v[2] = ( load64( s + 12 ) >> 6 ) & mask51;
+    h.v[3] = ( load64( s + 19 ) >> 1 ) & mask51;
+    h.v[4] = ( load64( s + 24 ) >> 12 ) & mask51;
+    return h;
+}
+
+// canonical little-endian encoding, fully reduced mod p
+inline void tobytes( uint8_t * s, fe h )
+{
+    h = carry( carry( h ) );
+
+    // h >= p exactly when h + 19 reaches 2^255
+    uint64_t q = ( h.v[0] + 19 ) >> 51;
+    q = ( h.v[1] + q ) >> 51;
+    q = ( h.v[2] + q ) >> 51;
+    q = ( h.v[3] + q ) >> 51;
+    q = ( h.v[4] + q ) >> 51;
+
+    h.v[0] += 19 * q;
+    h.v[1] += h.v[0] >> 51;
+    h.v[0] &= mask51;
+    h.v[2] += h.v[1] >> 51;
+    h.v[1] &= mask51;
+    h.v[3] += h.v[2] >> 51;
+    h.v[2] &= mask51;
+    h.v[4] += h.v[3] >> 51;
+    h.v[3] &= mask51;
+    h.v[4] &= mask51;
+
+    store64( s, h.v[0] | h.v[1] << 51 );
+    store64( s + 8, h.v[1] >> 13 | h.v[2] << 38 );
+    store64( s + 16, h.v[2] >> 26 | h.v[3] << 25 );
+    store64( s + 24, h.v[3] >> 39 | h.v[4] << 12 );
+}
+
+// Edwards points: extended ( X:Y:Z:T ), completed ( E:H:G:F ) and affine Niels ( y+x, y-x, 2dxy )
+
+struct ge_p3
+{
+    fe X, Y, Z, T;
+};
+
+struct ge_p1p1
+{
+    fe X, Y, Z, T;
+};
+
+struct ge_precomp
+{
+    fe yplusx, yminusx, xy2d;
+};
+
+inline ge_p3 p1p1_to_p3( const ge_p1p1 & p )
+{
+    ge_p3 r;
+    r.X = mul( p.X, p.T );
+    r.Y = mul( p.Y, p.Z );
+    r.Z = mul( p.Z, p.T );
+    r.T = mul( p.X, p.Y );
+    return r;
+}
+
+inline ge_p1p1 madd( const ge_p3 & p, const ge_precomp & q )
+{
+    ge_p1p1 r;
+    fe a = mul( sub( p.Y, p.X ), q.yminusx );
+    fe b = mul( add( p.Y, p.X ), q.yplusx );
+    fe c = mul( q.xy2d, p.T );
+    fe d = add( p.Z, p.Z );
+    r.X = sub( b, a );
+    r.Y = add( b, a );
+    r.Z = add( d, c );
+    r.T = sub( d, c );
+    return r;
+}
+
+// T of the input is not used
+inline ge_p1p1 dbl( const ge_p3 & p )
+{
+    ge_p1p1 r;
+    fe a = sq( p.X );
+    fe b = sq( p.Y );
+    fe c = sq( p.Z );
+    c = add( c, c );
+    fe e = sq( add( p.X, p.Y ) );
+    r.Y = add( b, a );
+    r.Z = carry( sub( b, a ) );
+    r.X = sub( e, r.Y );
+    r.T = sub( c, r.Z );
+    return r;
+}
+
+struct base_table
+{
+    // p[i][j] = ( j + 1 ) * 256^i * B
+    ge_precomp p[32][8];
+
+    base_table()
+    {
+        static const uint8_t bx[32] = { 0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9, 0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69, 0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0, 0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21 };
+        static const uint8_t by[32] = { 0x58, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66 };
+        static const uint8_t bd[32] = { 0xa3, 0x78, 0x59, 0x13, 0xca, 0x4d, 0xeb, 0x75, 0xab, 0xd8, 0x41, 0x41, 0x4d, 0x0a, 0x70, 0x00, 0x98, 0xe8, 0x79, 0x77, 0x79, 0x40, 0xc7, 0x8c, 0x73, 0xfe, 0x6f, 0x2b, 0xee, 0x6c, 0x03, 0x52 };
+
+        d2 = frombytes( bd );
+        d2 = carry( add( d2, d2 ) );
+
+        ge_p3 b;
+        b.X = frombytes( bx );
+        b.Y = frombytes( by );
+        b.Z = fe_one();
+        b.T = mul( b.X, b.Y );
+
+        for( int i = 0; i < 32; i++ )
+        {
+            ge_p3 q = b;
+            for( int j = 0; j < 8; j++ )
+            {
+                p[i][j] = precomp( q );
+                if( j < 7 )
+                    q = p1p1_to_p3( madd( q, p[i][0] ) );
+            }
+
+            for( int k = 0; k < 8; k++ )
+                b = p1p1_to_p3( dbl( b ) );
+        }
+    }
+
+    ge_precomp precomp( const ge_p3 & q ) const
+    {
+        fe zi = invert( q.Z );
+        fe x = mul( q.X, zi );
+        fe y = mul( q.Y, zi );
+        ge_precomp r;
+        r.yplusx = carry( add( y, x ) );
+        r.yminusx = carry( sub( y, x ) );
+        r.xy2d = mul( mul( x, y ), d2 );
+        return r;
+    }
+
+    // b * 256^pos * B for b in [-8, 8]
+    ge_precomp select( int pos, int b ) const
+    {
+        if( b == 0 )
+        {
+            ge_precomp r;
+            r.yplusx = fe_one();
+            r.yminusx = fe_one();
+            r.xy2d = fe_zero();
+            return r;
+        }
+
+        const ge_precomp & t = p[pos][( b < 0 ? -b : b ) - 1];
+        if( b > 0 )
+            return t;
+
+        ge_precomp r;
+        r.yplusx = t.yminusx;
+        r.yminusx = t.yplusx;
+        r.xy2d = neg( t.xy2d );
+        return r;
+    }
+
+    fe d2;
+};
+
+inline const base_table & table()
+{
+    static const base_table t;
+    return t;
+}
+
+// a * B on the Edwards curve for a clamped X25519 scalar
+inline ge_p3 scalarmult_base( const uint8_t * scalar )
+{
+    uint8_t a[32];
+    memcpy( a, scalar, 32 );
+    a[0] &= 248;
+    a[31] &= 127;
+    a[31] |= 64;
+
+    // signed radix 16 digits in [-8, 8)
+    int8_t e[64];
+    for( int i = 0; i < 32; i++ )
+    {
+        e[2 * i] = a[i] & 15;
+        e[2 * i + 1] = ( a[i] >> 4 ) & 15;
+    }
+    int8_t c = 0;
+    for( int i = 0; i < 63; i++ )
+    {
+        e[i] += c;
+        c = ( e[i] + 8 ) >> 4;
+        e[i] -= c * 16;
+    }
+    e[63] += c;
+
+    const base_table & t = table();
+    ge_p3 h;
+    h.X = fe_zero();
+    h.Y = fe_one();
+    h.Z = fe_one();
+    h.T = fe_zero();
+
+    for( int i = 1; i < 64; i += 2 )
+        h = p1p1_to_p3( madd( h, t.select( i / 2, e[i] ) ) );
+
+    for( int i = 0; i < 4; i++ )
+        h = p1p1_to_p3( dbl( h ) );
+
+    for( int i = 0; i < 64; i += 2 )
+        h = p1p1_to_p3( madd( h, t.select( i / 2, e[i] ) ) );
+
+    return h;
+}
+
+// out[i] = X25519( scalar[i], 9 ) for i < count, out may alias scalar
+inline void scalarmult_base_xN( uint8_t * const * out, const uint8_t * const * scalar, size_t count )
+{
+    static const size_t max_batch = 16;
+    for( size_t done = 0; done < count; done += max_batch )
+    {
+        size_t n = count - done < max_batch ? count - done : max_batch;
+
+        // u = ( Z + Y ) / ( Z - Y ), a clamped scalar is never a multiple of the
+        // group order so Z - Y never vanishes
+        fe num[max_batch], den[max_batch], acc[max_batch];
+        for( size_t i = 0; i < n; i++ )
+        {
+            ge_p3 p = scalarmult_base( scalar[done + i] );
+            num[i] = add( p.Z, p.Y );
+            den[i] = sub( p.Z, p.Y );
+            acc[i] = i ? mul( acc[i - 1], den[i] ) : carry( den[i] );
+        }
+
+        fe inv = invert( acc[n - 1] );
+        for( size_t i = n; i-- > 0; )
+        {
+            fe di = i ? mul( inv, acc[i - 1] ) : inv;
+            if( i )
+                inv = mul( inv, den[i] );
+            tobytes( out[done + i], mul( num[i], di ) );
+        }
+    }
+}
+
+inline void scalarmult_base( uint8_t * out, const uint8_t * scalar )
+{
+    scalarmult_base_xN( &out, &scalar, 1 );
+}
+
+} // namespace waves_x25519